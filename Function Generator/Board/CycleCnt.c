@@ -0,0 +1,20 @@
+/*****************************************************************************************
+* CycleCnt.c - Cortex-M4 DWT cycle counter support
+*
+* The counter is part of the debug trace block so trace has to be enabled in
+* DEMCR before CYCCNT will run, even when no debugger is attached.
+ ****************************************************************************************/
+#include "MCUType.h"
+#include "CycleCnt.h"
+
+/*****************************************************************************************
+* CycleCntInit - Enables and clears the DWT cycle counter. Safe to call more than once.
+ ****************************************************************************************/
+void CycleCntInit(void){
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    if((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0){
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }else{ /* Already running, leave the count alone */
+    }
+}
@@ -0,0 +1,15 @@
+/***************************************************************************************
+* CycleCnt.h - Cortex-M4 DWT cycle counter support
+*
+* CYCLE_CNT_GET() returns the free running core clock cycle count. Differences
+* between two readings are valid across a wrap as long as they are taken as an
+* unsigned 32-bit subtraction (about 23s at 180MHz).
+****************************************************************************************/
+#ifndef CYCLE_CNT_H_
+#define CYCLE_CNT_H_
+
+void CycleCntInit(void);
+
+#define CYCLE_CNT_GET() ((INT32U)DWT->CYCCNT)
+
+#endif /* CYCLE_CNT_H_ */
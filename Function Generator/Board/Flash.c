@@ -0,0 +1,101 @@
+/*****************************************************************************************
+* Flash.c - Program flash erase and program through the FTFE controller
+*
+* A command is loaded into the FCCOB registers and launched by clearing CCIF, which the
+* controller sets again when it is done. The flash cache and prefetch buffer are then
+* invalidated so reads see the new contents.
+*
+* Commands are not serialized here, the caller keeps one at a time.
+****************************************************************************************/
+#include "MCUType.h"
+#include "os.h"
+#include "Flash.h"
+
+#define FLASH_CMD_PROGRAM_PHRASE 0x07U
+#define FLASH_CMD_ERASE_SECTOR 0x09U
+#define FLASH_ERRORS (FTFE_FSTAT_ACCERR_MASK | FTFE_FSTAT_FPVIOL_MASK | FTFE_FSTAT_MGSTAT0_MASK)
+
+static void flashCmdLoad(INT8U cmd, INT32U addr);
+static INT8U flashCmdLaunch(INT8U dly);
+static INT8U flashAddrValid(INT32U addr, INT32U align);
+
+/*****************************************************************************************
+* FlashEraseSector - Erases the sector at addr
+****************************************************************************************/
+INT8U FlashEraseSector(INT32U addr){
+    INT8U ok = FALSE;
+
+    if(flashAddrValid(addr, FLASH_SECTOR_SIZE) == TRUE){
+        flashCmdLoad(FLASH_CMD_ERASE_SECTOR, addr);
+        ok = flashCmdLaunch(TRUE);
+    }else{}
+    return ok;
+}
+
+/*****************************************************************************************
+* FlashProgramPhrase - Programs one phrase. FCCOB4-7 take bytes 3-0 of the phrase and
+*                      FCCOB8-B bytes 7-4.
+****************************************************************************************/
+INT8U FlashProgramPhrase(INT32U addr, const INT8U *data){
+    INT8U ok = FALSE;
+
+    if(flashAddrValid(addr, FLASH_PHRASE_SIZE) == TRUE){
+        flashCmdLoad(FLASH_CMD_PROGRAM_PHRASE, addr);
+        FTFE_FCCOB4 = data[3];
+        FTFE_FCCOB5 = data[2];
+        FTFE_FCCOB6 = data[1];
+        FTFE_FCCOB7 = data[0];
+        FTFE_FCCOB8 = data[7];
+        FTFE_FCCOB9 = data[6];
+        FTFE_FCCOBA = data[5];
+        FTFE_FCCOBB = data[4];
+        ok = flashCmdLaunch(FALSE);
+    }else{}
+    return ok;
+}
+
+/*****************************************************************************************
+* flashCmdLoad - Waits out any command still running, clears the error flags left by the
+*                last one and loads the command and its 24 bit address
+****************************************************************************************/
+static void flashCmdLoad(INT8U cmd, INT32U addr){
+    while((FTFE_FSTAT & FTFE_FSTAT_CCIF_MASK) == 0){}
+    FTFE_FSTAT = FTFE_FSTAT_ACCERR_MASK | FTFE_FSTAT_FPVIOL_MASK;   //Write 1 to clear
+    FTFE_FCCOB0 = cmd;
+    FTFE_FCCOB1 = (INT8U)(addr >> 16);
+    FTFE_FCCOB2 = (INT8U)(addr >> 8);
+    FTFE_FCCOB3 = (INT8U)addr;
+}
+
+/*****************************************************************************************
+* flashCmdLaunch - Starts the loaded command and waits for it, a tick at a time if dly
+*                  is TRUE. Returns TRUE if it finished without an error.
+****************************************************************************************/
+static INT8U flashCmdLaunch(INT8U dly){
+    OS_ERR os_err;
+    INT8U ok = FALSE;
+
+    FTFE_FSTAT = FTFE_FSTAT_CCIF_MASK;
+    while((FTFE_FSTAT & FTFE_FSTAT_CCIF_MASK) == 0){
+        if(dly == TRUE){
+            OSTimeDly(1, OS_OPT_TIME_DLY, &os_err);
+        }else{}
+    }
+    FMC_PFB01CR |= FMC_PFB01CR_CINV_WAY(0xF) | FMC_PFB01CR_S_B_INV_MASK;
+    if((FTFE_FSTAT & FLASH_ERRORS) == 0){
+        ok = TRUE;
+    }else{}
+    return ok;
+}
+
+/*****************************************************************************************
+* flashAddrValid - TRUE if addr is aligned and in the upper block
+****************************************************************************************/
+static INT8U flashAddrValid(INT32U addr, INT32U align){
+    INT8U valid = FALSE;
+
+    if((addr >= FLASH_BLOCK1_ADDR) && (addr < FLASH_END_ADDR) && ((addr & (align - 1)) == 0)){
+        valid = TRUE;
+    }else{}
+    return valid;
+}
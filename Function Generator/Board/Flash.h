@@ -0,0 +1,32 @@
+/*****************************************************************************************
+* Flash.h - Program flash erase and program through the FTFE controller
+*
+* The K65's 2MB of program flash is two 1MB blocks, and one block can be read while the
+* other is being erased or programmed. The linker file ends m_text at FLASH_BLOCK1_ADDR
+* so all code and constants are in the lower block, and only addresses from
+* FLASH_BLOCK1_ADDR up may be written.
+****************************************************************************************/
+#ifndef FLASH_H_
+#define FLASH_H_
+
+#define FLASH_BLOCK1_ADDR 0x00100000U   //First address of the upper block
+#define FLASH_END_ADDR 0x00200000U
+#define FLASH_SECTOR_SIZE 0x1000U       //Erase unit
+#define FLASH_PHRASE_SIZE 8U            //Program unit, each phrase once per erase
+
+/*****************************************************************************************
+* FlashEraseSector - Erases the sector at addr, sector aligned, to all 0xFF. Delays a
+*                    tick at a time while the controller works (up to ~100ms), so call it
+*                    from a task only.
+*                    Returns TRUE on success, FALSE for a bad address or a flash error.
+****************************************************************************************/
+INT8U FlashEraseSector(INT32U addr);
+
+/*****************************************************************************************
+* FlashProgramPhrase - Programs FLASH_PHRASE_SIZE bytes of data at addr, phrase aligned,
+*                      which must be erased. Waits the ~60us it takes.
+*                      Returns TRUE on success, FALSE for a bad address or a flash error.
+****************************************************************************************/
+INT8U FlashProgramPhrase(INT32U addr, const INT8U *data);
+
+#endif /* FLASH_H_ */
@@ -0,0 +1,229 @@
+/*************************************************************************
+* LcdEmu.c - Model of a two line HD44780 display fed with the command
+*            stream of LcdLayered.c. Keeps the 80 byte DD RAM, address
+*            counter, entry mode, display shift and on/off control, so
+*            a snapshot shows what the glass would show, and counts the
+*            writes of each LCD task refresh to size lcdWriteBuffer().
+*
+*            Enabled with APP_CFG_LCD_EMU_EN in app_cfg.h. The counts and
+*            snapshot are only consistent when read from the LCD task or
+*            with it stopped in the debugger.
+*************************************************************************/
+#include "MCUType.h"
+#include "LcdEmu.h"
+
+#define LCD_EMU_RS        0x0100
+#define LCD_EMU_LINE_LEN  0x28         //DD RAM bytes per line
+#define LCD_EMU_LINE2     0x40         //Address of the second line
+#define LCD_EMU_CG_SIZE   0x40
+#define LCD_EMU_CURSOR_OFF 0xFF
+
+static INT8U lcdEmuDDRam[LCD_EMU_ROWS][LCD_EMU_LINE_LEN];
+static INT8U lcdEmuCGRam[LCD_EMU_CG_SIZE];
+static INT8U lcdEmuAddr;               //Address counter
+static INT8U lcdEmuCGMode;             //TRUE after a CG RAM address set
+static INT8U lcdEmuIncrement;          //Entry mode I/D
+static INT8U lcdEmuShiftOnWrite;       //Entry mode S
+static INT8U lcdEmuShift;              //Display shift, 0 to LCD_EMU_LINE_LEN-1
+static INT8U lcdEmuDispOn;
+static INT8U lcdEmuCursorOn;
+static LCD_EMU_COUNTS lcdEmuCur;
+static LCD_EMU_COUNTS lcdEmuLast;
+static LCD_EMU_COUNTS lcdEmuMax;
+
+static void lcdEmuClear(void);
+static void lcdEmuStepAddr(INT8U up);
+static void lcdEmuStepShift(INT8U right);
+
+/*************************************************************************
+* LcdEmuReset - Puts the model in the power on state
+*************************************************************************/
+void LcdEmuReset(void){
+    INT8U i;
+
+    lcdEmuClear();
+    for(i = 0; i < LCD_EMU_CG_SIZE; i++){
+        lcdEmuCGRam[i] = 0;
+    }
+    lcdEmuShiftOnWrite = FALSE;
+    lcdEmuDispOn = FALSE;
+    lcdEmuCursorOn = FALSE;
+    lcdEmuCur = (LCD_EMU_COUNTS){0, 0, 0};
+    lcdEmuLast = lcdEmuCur;
+    lcdEmuMax = lcdEmuCur;
+}
+
+/*************************************************************************
+* LcdEmuFeed - Decodes one command or data write
+*
+* Description:  Instructions are decoded by their highest set bit, as
+*               the controller does. Function set only selects the
+*               interface and line count, which LcdLayered.c never
+*               changes after init, so it is counted and ignored.
+*************************************************************************/
+void LcdEmuFeed(INT16U data){
+    INT8U c = (INT8U)data;
+
+    if((data & LCD_EMU_RS) != 0){
+        if(lcdEmuCGMode){
+            lcdEmuCGRam[lcdEmuAddr & (LCD_EMU_CG_SIZE - 1)] = c;
+            lcdEmuAddr = (lcdEmuIncrement ? (lcdEmuAddr + 1) : (lcdEmuAddr - 1))
+                         & (LCD_EMU_CG_SIZE - 1);
+            lcdEmuCur.cg_data++;
+        }else{
+            lcdEmuDDRam[(lcdEmuAddr >= LCD_EMU_LINE2) ? 1 : 0]
+                       [lcdEmuAddr & ~LCD_EMU_LINE2] = c;
+            lcdEmuStepAddr(lcdEmuIncrement);
+            if(lcdEmuShiftOnWrite){
+                lcdEmuStepShift(!lcdEmuIncrement);
+            }else{}
+            lcdEmuCur.data++;
+        }
+    }else{
+        lcdEmuCur.cmds++;
+        if((c & 0x80) != 0){                    //Set DD RAM address
+            lcdEmuAddr = c & 0x7F;
+            if((lcdEmuAddr & ~LCD_EMU_LINE2) >= LCD_EMU_LINE_LEN){
+                lcdEmuAddr &= LCD_EMU_LINE2;    //Undefined address, wrap to line start
+            }else{}
+            lcdEmuCGMode = FALSE;
+        }else if((c & 0x40) != 0){              //Set CG RAM address
+            lcdEmuAddr = c & (LCD_EMU_CG_SIZE - 1);
+            lcdEmuCGMode = TRUE;
+        }else if((c & 0x20) != 0){              //Function set
+        }else if((c & 0x10) != 0){              //Cursor or display shift
+            if((c & 0x08) != 0){
+                lcdEmuStepShift((c & 0x04) != 0);
+            }else{
+                lcdEmuStepAddr((c & 0x04) != 0);
+            }
+        }else if((c & 0x08) != 0){              //Display on/off control
+            lcdEmuDispOn = ((c & 0x04) != 0);
+            lcdEmuCursorOn = ((c & 0x03) != 0);
+        }else if((c & 0x04) != 0){              //Entry mode set
+            lcdEmuIncrement = ((c & 0x02) != 0);
+            lcdEmuShiftOnWrite = ((c & 0x01) != 0);
+        }else if((c & 0x02) != 0){              //Return home
+            lcdEmuAddr = 0;
+            lcdEmuShift = 0;
+            lcdEmuCGMode = FALSE;
+        }else if(c == 0x01){                    //Clear display
+            lcdEmuClear();
+        }else{}
+    }
+}
+
+/*************************************************************************
+* LcdEmuRefreshEnd - Closes the counts of the current refresh
+*************************************************************************/
+void LcdEmuRefreshEnd(void){
+    if(lcdEmuCur.data > lcdEmuMax.data){
+        lcdEmuMax.data = lcdEmuCur.data;
+    }else{}
+    if(lcdEmuCur.cg_data > lcdEmuMax.cg_data){
+        lcdEmuMax.cg_data = lcdEmuCur.cg_data;
+    }else{}
+    if(lcdEmuCur.cmds > lcdEmuMax.cmds){
+        lcdEmuMax.cmds = lcdEmuCur.cmds;
+    }else{}
+    lcdEmuLast = lcdEmuCur;
+    lcdEmuCur = (LCD_EMU_COUNTS){0, 0, 0};
+}
+
+/*************************************************************************
+* LcdEmuCounts - Copies the last and largest refresh counts
+*************************************************************************/
+void LcdEmuCounts(LCD_EMU_COUNTS *last, LCD_EMU_COUNTS *max){
+    *last = lcdEmuLast;
+    *max = lcdEmuMax;
+}
+
+/*************************************************************************
+* LcdEmuSnapshot - Writes the visible characters as text
+*
+* Description:  Display column col shows DD RAM column (col + shift)
+*               modulo the line length on both lines.
+*************************************************************************/
+INT8U LcdEmuSnapshot(INT8C *text){
+    INT8U row, col, ram_col, c;
+    INT8U cursor = LCD_EMU_CURSOR_OFF;
+
+    for(row = 0; row < LCD_EMU_ROWS; row++){
+        for(col = 0; col < LCD_EMU_COLS; col++){
+            ram_col = col + lcdEmuShift;
+            if(ram_col >= LCD_EMU_LINE_LEN){
+                ram_col -= LCD_EMU_LINE_LEN;
+            }else{}
+            c = lcdEmuDDRam[row][ram_col];
+            if(!lcdEmuDispOn){
+                c = ' ';
+            }else if(c < 0x10){
+                c = '#';
+            }else if((c < 0x20) || (c > 0x7E)){
+                c = '?';
+            }else{}
+            *text++ = (INT8C)c;
+            if(lcdEmuDispOn && lcdEmuCursorOn && !lcdEmuCGMode &&
+               (lcdEmuAddr == ((row * LCD_EMU_LINE2) + ram_col))){
+                cursor = (row * LCD_EMU_COLS) + col;
+            }else{}
+        }
+        *text++ = '\n';
+    }
+    *text = 0;
+    return cursor;
+}
+
+/*************************************************************************
+* lcdEmuClear - Clear display: DD RAM to spaces, address and shift to 0,
+*               entry mode to increment. CG RAM and on/off are kept.
+*************************************************************************/
+static void lcdEmuClear(void){
+    INT8U row, col;
+
+    for(row = 0; row < LCD_EMU_ROWS; row++){
+        for(col = 0; col < LCD_EMU_LINE_LEN; col++){
+            lcdEmuDDRam[row][col] = 0x20;
+        }
+    }
+    lcdEmuAddr = 0;
+    lcdEmuShift = 0;
+    lcdEmuCGMode = FALSE;
+    lcdEmuIncrement = TRUE;
+}
+
+/*************************************************************************
+* lcdEmuStepAddr - Moves the DD RAM address counter one place, wrapping
+*                  from the end of one line to the start of the other
+*************************************************************************/
+static void lcdEmuStepAddr(INT8U up){
+    if(up){
+        if(lcdEmuAddr == (LCD_EMU_LINE_LEN - 1)){
+            lcdEmuAddr = LCD_EMU_LINE2;
+        }else if(lcdEmuAddr == (LCD_EMU_LINE2 + LCD_EMU_LINE_LEN - 1)){
+            lcdEmuAddr = 0;
+        }else{
+            lcdEmuAddr++;
+        }
+    }else{
+        if(lcdEmuAddr == 0){
+            lcdEmuAddr = LCD_EMU_LINE2 + LCD_EMU_LINE_LEN - 1;
+        }else if(lcdEmuAddr == LCD_EMU_LINE2){
+            lcdEmuAddr = LCD_EMU_LINE_LEN - 1;
+        }else{
+            lcdEmuAddr--;
+        }
+    }
+}
+
+/*************************************************************************
+* lcdEmuStepShift - Shifts the display window one place. A right shift
+*                   moves the text right, showing lower addresses.
+*************************************************************************/
+static void lcdEmuStepShift(INT8U right){
+    if(right){
+        lcdEmuShift = (lcdEmuShift == 0) ? (LCD_EMU_LINE_LEN - 1) : (lcdEmuShift - 1);
+    }else{
+        lcdEmuShift = (lcdEmuShift == (LCD_EMU_LINE_LEN - 1)) ? 0 : (lcdEmuShift + 1);
+    }
+}
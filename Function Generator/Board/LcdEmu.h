@@ -0,0 +1,56 @@
+/*************************************************************************
+* LcdEmu.h - HD44780 command stream decoder for LcdLayered.c
+*
+* Commands are the 9-bit values LcdLayered.c queues, bit 8 is RS. Has no
+* hardware or kernel dependencies so it also builds on a host, where a
+* test feeds it commands and prints LcdEmuSnapshot().
+*************************************************************************/
+#ifndef LCD_EMU_H_
+#define LCD_EMU_H_
+
+#define LCD_EMU_ROWS      2
+#define LCD_EMU_COLS      16
+#define LCD_EMU_SNAP_SIZE ((LCD_EMU_ROWS*(LCD_EMU_COLS+1))+1)  //Rows, '\n's, NUL
+
+typedef struct{
+    INT16U data;        //Bytes written to DD RAM
+    INT16U cg_data;     //Bytes written to CG RAM
+    INT16U cmds;        //Instructions, address sets included
+} LCD_EMU_COUNTS;
+
+/*************************************************************************
+* LcdEmuReset - Puts the model in the power on state, display off and
+*               DD RAM filled with spaces. Clears all counts.
+*************************************************************************/
+void LcdEmuReset(void);
+
+/*************************************************************************
+* LcdEmuFeed - Decodes one command or data write
+*************************************************************************/
+void LcdEmuFeed(INT16U data);
+
+/*************************************************************************
+* LcdEmuRefreshEnd - Closes the counts of the current refresh, starts new
+*************************************************************************/
+void LcdEmuRefreshEnd(void);
+
+/*************************************************************************
+* LcdEmuCounts - Copies the counts of the last closed refresh and the
+*                largest of each seen since LcdEmuReset()
+*************************************************************************/
+void LcdEmuCounts(LCD_EMU_COUNTS *last, LCD_EMU_COUNTS *max);
+
+/*************************************************************************
+* LcdEmuSnapshot - Writes the visible characters as text, one line per
+*                  row. CG RAM codes show as '#', other unprintable
+*                  codes as '?', and everything as spaces while the
+*                  display is off.
+*
+* Arguments:    text - LCD_EMU_SNAP_SIZE characters
+*
+* Return value: Cursor as row*LCD_EMU_COLS+col, or 0xFF if it is off or
+*               outside the visible window
+*************************************************************************/
+INT8U LcdEmuSnapshot(INT8C *text);
+
+#endif /* LCD_EMU_H_ */
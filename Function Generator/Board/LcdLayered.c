@@ -1,868 +1,1548 @@
-/****************************************************************************************
-* LcdLayered.c - A MicroC/OS driver for for a Hitachi-type LCD Display
-*                                                                        
-*                This LCD driver implements the concept of layers.       
-*                This allows asynchronous application tasks to write to  
-*                a single LCD display without interfering with each      
-*                other.                                                  
-*                                                                        
-*                Requires the following be defined in app_cfg.h:         
-*                   APP_CFG_LCD_TASK_PRIO
-*                   APP_CFG_LCD_TASK_STK_SIZE
-*                                                                        
-*                It is derived from the work of Matthew Cohn, 2/26/2008
-*                
-*                Cursor code is derived from Keegan Morrow, 02/22/2013  
-*                                                                        
-* Todd Morton, 02/26/2013, First Revised Release
-* 01/22/2015, Added to git repo, general clean up. TDM
-* 02/03/2016, More cleanup. TDM
-* 01/13/2017 Changed name to LcdLayered (was LayeredLcd), fixed bugs. TDM
-* 01/18/2018 Changed to replace includes.h TDM
-* 02/01/2018 Brian Willis changed lcdLayeredTask() DB Bit from 3 to 4
-*****************************************************************************************
-* Header Files - Dependencies
-*****************************************************************************************/
-#include "MCUType.h"
-#include "app_cfg.h"
-#include "os.h"
-#include "LcdLayered.h"
-#include "K65TWR_GPIO.h"
-
-/*****************************************************************************************
-* LCD Port Defines 
-*****************************************************************************************/
-#define LCD_RS_BIT     0x2
-#define LCD_E_BIT      0x4
-#define LCD_DB_MASK    0x78
-#define LCD_PORT       GPIOD_PDOR
-#define LCD_PORT_DIR   GPIOD_PDDR
-#define INIT_BIT_DIR() (LCD_PORT_DIR |= (LCD_RS_BIT|LCD_E_BIT|LCD_DB_MASK))
-#define LCD_SET_RS()   GPIOD_PSOR = LCD_RS_BIT
-#define LCD_CLR_RS()   GPIOD_PCOR = LCD_RS_BIT
-#define LCD_SET_E()    GPIOD_PSOR = LCD_E_BIT
-#define LCD_CLR_E()    GPIOD_PCOR = LCD_E_BIT
-#define LCD_WR_DB(nib) (GPIOD_PDOR = (GPIOD_PDOR & ~LCD_DB_MASK)|((nib)<<3))
-
-
-/*****************************************************************************************
-* LCD Defines                                                                            *
-*****************************************************************************************/
-// LCD Configuration
-#define LCD_NUM_ROWS   2
-#define LCD_NUM_COLS   16
-
-#define LCD_ENABLE     0x04
-#define LCD_CLEAR_BYTE 0x20    //SPACE is set as the transparent character
-
-// LCD Cursor typedef
-typedef struct {
-    INT8U col;
-    INT8U row;
-    INT8U on;
-    INT8U blink;
-}LCD_CURSOR;
-
-// LCD layer and buffer typdedef
-typedef struct {
-    INT8C lcd_char[LCD_NUM_ROWS][LCD_NUM_COLS];
-    INT8U hidden;
-    LCD_CURSOR cursor;
-} LCD_BUFFER;
-
-/*************************************************************************
-  Private Local Functions
-*************************************************************************/
-static void lcdDlyus(INT16U us);
-static void lcdDly500ns(void);
-static void lcdWrite(INT16U data);
-static void lcdClear(LCD_BUFFER *buffer);
-
-static void lcdFlattenLayers(LCD_BUFFER *dest_buffer,
-                             LCD_BUFFER *src_layers);
-static void lcdWriteBuffer(LCD_BUFFER *buffer);
-static void lcdMoveCursor(INT8U row, INT8U col);
-
-/*************************************************************************
-  MicroC/OS Resources
-*************************************************************************/
-static OS_TCB lcdLayeredTaskTCB;
-static void lcdLayeredTask(void *p_arg);
-static OS_MUTEX lcdLayersKey;
-static CPU_STK lcdLayeredTaskStk[APP_CFG_LCD_TASK_STK_SIZE];
-
-/*************************************************************************
-  Global Variables
-*************************************************************************/
-// Stored Constants
-static const INT8U lcdRowAddress[LCD_NUM_ROWS] = {0x00, 0x40};
-
-// Static Globals
-static LCD_BUFFER lcdBuffer;
-static LCD_BUFFER lcdPreviousBuffer;
-static LCD_BUFFER lcdLayers[LCD_NUM_LAYERS];
-
-/*************************************************************************
-  LCD Command Macros
-*************************************************************************/
-/*                                                    R R D D D D D D D D
-                                                      / S B B B B B B B B
-                                                      W   7 6 5 4 3 2 1 0
-*/
-// Clear Display                                      0 0 0 0 0 0 0 0 0 1
-#define LCD_CLR_DISP()         (0x0001)      
-// Return Home                                        0 0 0 0 0 0 0 0 1 *
-#define LCD_CUR_HOME()         (0x0002)      
-// Entry Mode Set                                     0 0 0 0 0 0 0 1 ids
-#define LCD_ENTRY_MODE(id, s)  (0x0004                       \
-                                | ((INT16U)id ? 0x0002 : 0)  \
-                                | ((INT16U)s  ? 0x0001 : 0))
-// Display ON/OFF Control                             0 0 0 0 0 0 1 d c b
-#define LCD_ON_OFF(d, c, b)    (0x0008                       \
-                                | ((INT16U)d  ? 0x0004 : 0)  \
-                                | ((INT16U)c  ? 0x0002 : 0)  \
-                                | ((INT16U)b  ? 0x0001 : 0))
-// Cursor or Display Shift                            0 0 0 0 0 1 scrl* *
-#define LCD_SHIFT(sc, rl)      (0x0010                       \
-                                | ((INT16U)sc ? 0x0008 : 0)  \
-                                | ((INT16U)rl ? 0x0004 : 0))
-// Function Set                                       0 0 0 0 1 dln f * *
-#define LCD_FUNCTION(dl, n, f) (0x0020                       \
-                                | ((INT16U)dl ? 0x0010 : 0)  \
-                                | ((INT16U)n  ? 0x0008 : 0)  \
-                                | ((INT16U)f  ? 0x0004 : 0))
-// Set CG RAM Address                                 0 0 0 1 ----acg-----
-#define LCD_CG_RAM(acg)        (0x0040                       \
-                                | ((INT16U)agc  & 0x003F))
-// Set DD RAM Address                                 0 0 1 -----add------
-#define LCD_DD_RAM(add)        (0x0080                       \
-                                | (((INT16U)add)  & 0x007F))
-// Write Data to CG or DD RAM                         0 1 ------data------
-#define LCD_WRITE(data)        (0x0100                       \
-                                | ((INT16U)data & 0x00FF))
-                                                                       
-/******************************************************************************
-  lcdLayeredTask() - Handles writing to the LCD module      (Private Task)
-  
-        When writing to the LCD, will block until thescreen is updated.  
-        This is worst-case x.xms, but will be much lower if not every character 
-        on the screen is changing.
-******************************************************************************/
-static void lcdLayeredTask(void *p_arg) {
-    OS_ERR os_err;
-    
-    // Avoid compiler warning
-    (void)p_arg;
-    
-    while(1) {
-    
-        // Wait for an lcd layer to be modified
-    	DB4_TURN_OFF();
-        OSTaskSemPend(0,OS_OPT_PEND_BLOCKING,(CPU_TS *)0, &os_err);
-    	DB4_TURN_ON();
-        
-        lcdFlattenLayers(&lcdBuffer, (LCD_BUFFER *)&lcdLayers);
-        lcdWriteBuffer(&lcdBuffer);
-    }
-}
-
-/*************************************************************************
-  LcdCursor                                                       (Public)
-
-
-  DESCRIPTION: Sets the cursor position, blinking, and visibility
-
-  RETURNS: TRUE if no error, FALSE otherwise
-*************************************************************************/
-INT8U LcdCursor(INT8U row, INT8U col, INT8U layer, INT8U on, INT8U blink){
-    INT8U noerr = TRUE;
-    OS_ERR os_err;
-    
-    OSMutexPend(&lcdLayersKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
-
-    if ((layer < LCD_NUM_LAYERS) && (col <= LCD_NUM_COLS) && (row <= LCD_NUM_ROWS)){
-        lcdLayers[layer].cursor.col = col;
-        lcdLayers[layer].cursor.row = row;
-        if ( blink ){
-            lcdLayers[layer].cursor.blink = TRUE;
-        }else{
-            lcdLayers[layer].cursor.blink = FALSE;
-        }
-        if ( on ){
-            lcdLayers[layer].cursor.on = TRUE;
-        }else{
-            lcdLayers[layer].cursor.on = FALSE;
-        }
-    }else{
-        noerr = FALSE;
-    }
-
-    (void)OSMutexPost(&lcdLayersKey, OS_OPT_POST_NONE, &os_err);
-
-    // We have modified a layer
-    (void)OSTaskSemPost(&lcdLayeredTaskTCB, OS_OPT_POST_NONE, &os_err);
-
-    return(noerr);
-}
-/*************************************************************************
-  LcdDispClear() - Clears a layer                                 (Public)   
-
-                   Pends on the lcdLayersKey mutex
-                   Posts the lcdModifiedFlag semaphore
-*************************************************************************/
-void LcdDispClear(INT8U layer) {
-    OS_ERR os_err;
-    LCD_BUFFER *llayer = &lcdLayers[layer];
-
-    OSMutexPend(&lcdLayersKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
-    while(os_err != OS_ERR_NONE){           /* Error Trap                        */
-    }
-
-    lcdClear(llayer);
-
-    (void)OSMutexPost(&lcdLayersKey, OS_OPT_POST_NONE, &os_err);
-    while(os_err != OS_ERR_NONE){           /* Error Trap                        */
-    }
-    
-    // We have modified a layer
-    (void)OSTaskSemPost(&lcdLayeredTaskTCB, OS_OPT_POST_NONE, &os_err);
-}
-
-
-/*************************************************************************
-  LcdDispClrLine() - Clears a line of a layer                     (Public)   
-
-                     Pends on the lcdLayersKey mutex
-                     Posts the lcdModifiedFlag semaphore
-*************************************************************************/
-void LcdDispClrLine(INT8U row, INT8U layer) {
-    INT8U col;
-    OS_ERR os_err;
-    
-    LCD_BUFFER *llayer = &lcdLayers[layer];
-    
-    OSMutexPend(&lcdLayersKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
-    while(os_err != OS_ERR_NONE){           /* Error Trap                        */
-    }
-    
-    // For each column...
-    for(col = 0; col < LCD_NUM_COLS; col++) {
-
-        // Clear the character at that position
-        llayer->lcd_char[row-1][col] = LCD_CLEAR_BYTE;
-    }
-    
-    (void)OSMutexPost(&lcdLayersKey, OS_OPT_POST_NONE, &os_err);
-    while(os_err != OS_ERR_NONE){           /* Error Trap                        */
-    }
-    
-    // We have modified a layer
-    (void)OSTaskSemPost(&lcdLayeredTaskTCB,OS_OPT_POST_NONE,&os_err);
-}
-
-
-/*************************************************************************
-  LcdDispString() - Writes a null terminated string to a layer    (Public)
-
-                    Pends on the lcdLayersKey mutex
-                    Posts the lcdModifiedFlag semaphore
-*************************************************************************/
-void LcdDispString(INT8U row,
-                   INT8U col,
-                   INT8U layer,
-                   const INT8C *string) {
-
-    OS_ERR os_err;
-    INT8U cnt, row_index, col_index;
-    LCD_BUFFER *llayer = &lcdLayers[layer];
-
-    row_index = row - 1;
-    col_index = col - 1;
-    
-    OSMutexPend(&lcdLayersKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
-    while(os_err != OS_ERR_NONE){           /* Error Trap                        */
-    }
-    
-    // Iterate through the string until we reach a null
-    for(cnt = 0; string[cnt] != 0x00; cnt++) {
-    
-        if((col_index+cnt) < LCD_NUM_COLS){ // not at end of row
-            // Copy from the passed paramater to the layer
-            llayer->lcd_char[row_index][col_index+cnt] = string[cnt];
-        }else{ //outside buffer
-        }
-    }
-    
-    (void)OSMutexPost(&lcdLayersKey, OS_OPT_POST_NONE, &os_err);
-    while(os_err != OS_ERR_NONE){           /* Error Trap                        */
-    }
-    
-    // We have modified a layer
-    (void)OSTaskSemPost(&lcdLayeredTaskTCB,OS_OPT_POST_NONE,&os_err);
-}
-
-
-
-/*************************************************************************
-  LcdDispChar() - Writes a character to a layer                   (Public)
-
-                  Pends on the lcdLayersKey mutex
-                  Posts the lcdModifiedFlag semaphore
-*************************************************************************/
-void LcdDispChar(INT8U row,
-                 INT8U col,
-                 INT8U layer,
-                 INT8C character) {
-    OS_ERR os_err;
-    INT8U row_index, col_index;
-    LCD_BUFFER *llayer = &lcdLayers[layer];
-
-    row_index = row - 1;
-    col_index = col - 1;
-    
-    if(col_index < LCD_NUM_COLS){
-        OSMutexPend(&lcdLayersKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
-        while(os_err != OS_ERR_NONE){           /* Error Trap                        */
-        }
-    
-        // Copy from the passed paramater to the layer
-        llayer->lcd_char[row_index][col_index] = character;
-    
-        (void)OSMutexPost(&lcdLayersKey, OS_OPT_POST_NONE, &os_err);
-        while(os_err != OS_ERR_NONE){           /* Error Trap                        */
-        }
-    
-        // We have modified a layer
-        (void)OSTaskSemPost(&lcdLayeredTaskTCB,OS_OPT_POST_NONE,&os_err);
-    }else{ //outside layer
-    }
-}
-
-
-
-/*************************************************************************
-  LcdDispByte - Writes the ASCII representation of a byte to a    (Public)
-                layer in hex
-
-                Pends on the lcdLayersKey mutex
-                Posts the lcdModifiedFlag semaphore
-*************************************************************************/
-void LcdDispByte(INT8U row, INT8U col, INT8U layer, INT8U byte) {
-    OS_ERR os_err;
-    INT8U row_index, col_index;
-    LCD_BUFFER *llayer = &lcdLayers[layer];
-    
-    // Convert row / col index 1 to index 0
-    row_index = row - 1;
-    col_index = col - 1;
-    
-    if(col < LCD_NUM_COLS){
-        OSMutexPend(&lcdLayersKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
-        while(os_err != OS_ERR_NONE){           /* Error Trap                        */
-        }
-
-        llayer->lcd_char[row_index][col_index+0] = (byte >> 4);   // MSB
-        llayer->lcd_char[row_index][col_index+1] = (byte & 0x0F); // LSB
-    
-        // Convert MSB to ASCII character
-        llayer->lcd_char[row_index][col_index+0] +=
-            (llayer->lcd_char[row_index][col_index+0] <= 9 ? '0' : 'A' - 10);
-
-        // Convert LSB to ASCII character
-        llayer->lcd_char[row_index][col_index+1] +=
-            (llayer->lcd_char[row_index][col_index+1] <= 9 ? '0' : 'A' - 10);
-
-
-        (void)OSMutexPost(&lcdLayersKey, OS_OPT_POST_NONE, &os_err);
-        while(os_err != OS_ERR_NONE){           /* Error Trap                        */
-        }
-
-        // We have modified a layer
-        (void)OSTaskSemPost(&lcdLayeredTaskTCB,OS_OPT_POST_NONE,&os_err);
-        while(os_err != OS_ERR_NONE){           /* Error Trap                        */
-        }
-    }else{ //outside layer
-    }
-}
-
-
-/*************************************************************************
-  LcdDispDecByte - Writes the ASCII representation of a byte to a (Public)
-                   layer in decimal
-
-                   Pends on the lcdLayersKey mutex
-                   Posts the lcdModifiedFlag semaphore
-*************************************************************************/
-void LcdDispDecByte(INT8U row,
-                    INT8U col,
-                    INT8U layer,
-                    INT8U byte,
-                    INT8U lzeros) {
-    
-    OS_ERR os_err;
-    INT8U row_index, col_index, hunds, tens, ones;
-    LCD_BUFFER *llayer = &lcdLayers[layer];
-    
-    if((col + 1) < LCD_NUM_COLS){
-        // Convert row / col index 1 to index 0
-        row_index = row - 1;
-        col_index = col - 1;
-    
-        hunds = byte / 100;
-        tens = (byte / 10) % 10;
-        ones = byte % 10;
-    
-        OSMutexPend(&lcdLayersKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
-        while(os_err != OS_ERR_NONE){           /* Error Trap                        */
-        }
-
-        if(lzeros == 1 || hunds > 0) {
-            llayer->lcd_char[row_index][col_index+0] = hunds; // Hundreds
-            llayer->lcd_char[row_index][col_index+0] += '0';  //  --> ASCII
-        }
-
-        if(lzeros == 1 || hunds > 0 || tens > 0) {
-            llayer->lcd_char[row_index][col_index+1] = tens;  // Tens
-            llayer->lcd_char[row_index][col_index+1] += '0';  //  --> ASCII
-        }
-    
-        llayer->lcd_char[row_index][col_index+2] = ones;      // Ones
-        llayer->lcd_char[row_index][col_index+2] += '0';      //  --> ASCII
-        
-
-        (void)OSMutexPost(&lcdLayersKey, OS_OPT_POST_NONE, &os_err);
-        while(os_err != OS_ERR_NONE){           /* Error Trap                        */
-        }
-
-        // We have modified a layer
-        (void)OSTaskSemPost(&lcdLayeredTaskTCB,OS_OPT_POST_NONE,&os_err);
-        while(os_err != OS_ERR_NONE){           /* Error Trap                        */
-        }
-    }else{ //outside layer
-    }
-}
-
-/*************************************************************************
-  LcdDispTime - Writes a time to a layer                          (Public)
-
-                Pends on the lcdLayersKey mutex
-                Posts the lcdModifiedFlag semaphore
-*************************************************************************/
-void LcdDispTime(INT8U row,
-                 INT8U col,
-                  INT8U layer,
-                 INT8U hrs,
-                 INT8U mins,
-                 INT8U secs) {
-    OS_ERR os_err;
-    INT8U row_index, col_index;
-    LCD_BUFFER *llayer = &lcdLayers[layer];
-
-    if((col + 6) < LCD_NUM_COLS){
-        // Convert row / col index 1 to index 0
-        row_index = row - 1;
-        col_index = col - 1;
-
-    
-        OSMutexPend(&lcdLayersKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
-        while(os_err != OS_ERR_NONE){           /* Error Trap                        */
-        }
-    
-
-        llayer->lcd_char[row_index][col_index+0] = hrs / 10 + '0';
-        llayer->lcd_char[row_index][col_index+1] = hrs % 10 + '0';
-
-        llayer->lcd_char[row_index][col_index+2] = ':';
-
-        llayer->lcd_char[row_index][col_index+3] = mins / 10 + '0';
-        llayer->lcd_char[row_index][col_index+4] = mins % 10 + '0';
-
-        llayer->lcd_char[row_index][col_index+5] = ':';
-
-        llayer->lcd_char[row_index][col_index+6] = secs / 10 + '0';
-        llayer->lcd_char[row_index][col_index+7] = secs % 10 + '0';
-    
-           
-        (void)OSMutexPost(&lcdLayersKey, OS_OPT_POST_NONE, &os_err);
-        while(os_err != OS_ERR_NONE){           /* Error Trap                        */
-        }
-    
-        // We have modified a layer
-        (void)OSTaskSemPost(&lcdLayeredTaskTCB,OS_OPT_POST_NONE,&os_err);
-    }else{ //outside layer
-    }
-}
-
-
-/******************************************************************************
-  LcdInit() - Initializes the LCD                                 (Public)
-
-        Initializes the LCD hardware, sets up our semaphores/mutexes/task,
-        clears all of our buffers and layers.  This needs to be run before
-        any other function that accesses the LCD.
-******************************************************************************/
-void LcdInit(void) {
-    INT8U layer_cnt;
-    OS_ERR os_err;
-    
-    // Create mutex key, semaphore, and task
-    OSMutexCreate(&lcdLayersKey,"LCD Layers Key", &os_err);
-    while(os_err != OS_ERR_NONE){           /* Error Trap                        */
-    }
-
-    OSTaskCreate((OS_TCB     *)&lcdLayeredTaskTCB,
-                (CPU_CHAR   *)"Layered LCD Task",
-                (OS_TASK_PTR ) lcdLayeredTask,
-                (void       *) 0,
-                (OS_PRIO     ) APP_CFG_LCD_TASK_PRIO,
-                (CPU_STK    *)&lcdLayeredTaskStk[0],
-                (CPU_STK     )(APP_CFG_LCD_TASK_STK_SIZE / 10u),
-                (CPU_STK_SIZE) APP_CFG_LCD_TASK_STK_SIZE,
-                (OS_MSG_QTY  ) 0,
-                (OS_TICK     ) 0,
-                (void       *) 0,
-                (OS_OPT      )(OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR),
-                (OS_ERR     *)&os_err);
-    while(os_err != OS_ERR_NONE){           /* Error Trap                        */
-    }
-
-    // Perform LCD hardware initialisation
-    SIM_SCGC5 |= SIM_SCGC5_PORTD_MASK;              /* Enable clock gate for PORTD */
-    PORTD_PCR1=(0|PORT_PCR_MUX(1));
-    PORTD_PCR2=(0|PORT_PCR_MUX(1));
-    PORTD_PCR3=(0|PORT_PCR_MUX(1));
-    PORTD_PCR4=(0|PORT_PCR_MUX(1));
-    PORTD_PCR5=(0|PORT_PCR_MUX(1));
-    PORTD_PCR6=(0|PORT_PCR_MUX(1));
-    INIT_BIT_DIR();
-    LCD_CLR_E(); 
-    LCD_SET_RS();           /*Data select unless in LcdWrCmd()  */
-    lcdDlyus(15000);           /* LCD requires 15ms delay at powerup */
-   
-    LCD_CLR_RS();           /*Send first command for RESET sequence*/
-    LCD_WR_DB(0x3);
-    LCD_SET_E();
-    lcdDly500ns();
-    LCD_CLR_E();
-    lcdDlyus(4200);            /*Wait >4.1ms */
-  
-    LCD_WR_DB(0x3);         /*Repeat */
-    LCD_SET_E();
-    lcdDly500ns();
-    LCD_CLR_E();
-    lcdDlyus(101);            /*Wait >100us */
-  
-    LCD_WR_DB(0x3);         /* Repeat */
-    LCD_SET_E();
-    lcdDly500ns();
-    LCD_CLR_E();
-    lcdDlyus(41);           /*Wait >40us*/
-  
-    LCD_WR_DB(0x2);         /*Send last command for RESET sequence*/
-    LCD_SET_E();
-    lcdDly500ns();
-    LCD_CLR_E();
-    lcdDlyus(41);
-  
-    lcdWrite(LCD_FUNCTION(0, 1, 0));     /*Send command for 4-bit mode */
-    lcdWrite(LCD_ENTRY_MODE(1, 0)); // Increment, no shift
-    lcdWrite(LCD_ON_OFF(1, 0, 0));  // LCD on, cursor off, blink off
-    lcdWrite(LCD_CLR_DISP());       // Clear display
-    lcdDlyus(1650);
-    lcdWrite(LCD_DD_RAM(0x0000));   // Reset cursor
-    
-    
-    // Clear all of our layers
-    for(layer_cnt = 0; layer_cnt < LCD_NUM_LAYERS; layer_cnt++) {
-        lcdClear(&lcdLayers[layer_cnt]);
-    }
-    
-    // Clear the current buffer
-    // and the previous buffer
-    lcdClear(&lcdBuffer);
-    lcdClear(&lcdPreviousBuffer);
-}
-
-
-/*************************************************************************
-  lcdFlattenLayers() - Combines *src_layers onto *dest_buffer    (Private)
-
-        The src_layer with the lowest index will be on the bottom, the
-        src_layer with the highest index will be on the top.  Treats the
-        character defined as LCD_CLEAR_BYTE as a transparent byte.
-
-                       Pends on the lcdLayersKey mutex
-*************************************************************************/
-static void lcdFlattenLayers(LCD_BUFFER *dest_buffer,
-                             LCD_BUFFER *src_layers) {
-    
-    INT8U layer, row, col, current_char;
-    OS_ERR os_err;
-    // Clear the destination buffer
-    lcdClear(dest_buffer);
-
-//    DBUG_PORT &= ~DBUG_LCDTASK;
-    OSMutexPend(&lcdLayersKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
-    while(os_err != OS_ERR_NONE){           /* Error Trap                        */
-    }
-//    DBUG_PORT |= DBUG_LCDTASK;
-    // Set the destination buffer cursor to false initially
-    dest_buffer->cursor.on = FALSE;
-    dest_buffer->cursor.blink = FALSE;
-
-    // For each layer...
-    for(layer = 0; layer < LCD_NUM_LAYERS; layer++) {
-
-        // If that layer is not hidden...
-        if((src_layers+layer)->hidden == 0) {
-            // For each row...
-            for(row = 0; row < LCD_NUM_ROWS; row++) {
-                // For each column...
-                for(col = 0; col < LCD_NUM_COLS; col++) {
-                    current_char = (src_layers+layer)->lcd_char[row][col];
-                
-                    // If the source layer is not null
-                    if(current_char != LCD_CLEAR_BYTE) {
-                        // Copy from the source layer to the buffer
-                        dest_buffer->lcd_char[row][col] = current_char;
-                    }else{ //Do nothing - transparent
-                    }
-                    
-                } // column
-            } // row
-
-            //Handle the cursor status
-//            if ( (src_layers+layer)->cursor.on != FALSE){
-                dest_buffer->cursor.col = (src_layers+layer)->cursor.col;
-                dest_buffer->cursor.row = (src_layers+layer)->cursor.row;
-                dest_buffer->cursor.on = (src_layers+layer)->cursor.on;
-                dest_buffer->cursor.blink = (src_layers+layer)->cursor.blink;
-//            }else{
-                // This layer doesn't move the cursor, do nothing
-//            }
-        }else{ //Do nothing - layer is hidden
-        }
-    } // layer
-    
-    (void)OSMutexPost(&lcdLayersKey, OS_OPT_POST_NONE, &os_err);
-    while(os_err != OS_ERR_NONE){           /* Error Trap                        */
-    }
-
-}
-
-
-/*************************************************************************
-  lcdWriteBuffer() - Sends an LCD_BUFFER buffer to lcdWrite()    (Private)
-  
-        The previous buffer lcdPreviousBuffer is a global variable
-        containing a copy of the actual contents of the LCD module.  By 
-        using the lcdPreviousBuffer and repos_flag, we are able to only
-        write bytes that have changed.
-                                                           
-                     Blocks for as long as lcdWrite() blocks
-*************************************************************************/
-static void lcdWriteBuffer(LCD_BUFFER *buffer) {
-    INT8U row, col, repos_flag;
-    
-    // For each row...
-    for(row = 0; row < LCD_NUM_ROWS; row++) {
-    
-        // Set our cursor to the beginning of the row
-        lcdWrite(LCD_DD_RAM(lcdRowAddress[row]));
-        repos_flag = 0;
-        
-        // For each column...
-        for(col = 0; col < LCD_NUM_COLS; col++) {
-
-            // If the character at the current position has changed...
-            if(lcdPreviousBuffer.lcd_char[row][col]
-                != buffer->lcd_char[row][col]) {
-                
-                // If we need to reposition, do that now
-                if(repos_flag == 1) {
-                    lcdWrite(LCD_DD_RAM((lcdRowAddress[row] + col)));
-                    repos_flag = 0;
-                }
-            
-                // Write the character to the LCD
-                lcdWrite(LCD_WRITE(buffer->lcd_char[row][col]));
-             
-                // And update the previous buffer
-                lcdPreviousBuffer.lcd_char[row][col] =
-                    buffer->lcd_char[row][col];
-            } else {
-                // Otherwise we don't write the character... but we need
-                //   to set the reposition flag
-                
-                repos_flag = 1;
-            }
-            
-        
-        }
-    }
-    // At the end setup the cursor
-    lcdMoveCursor(buffer->cursor.row,buffer->cursor.col);
-    LcdCursorDispMode(buffer->cursor.on, buffer->cursor.blink);
-
-}
-
-/******************************************************************************
-  lcdWrite() - Writes a command (both data and control busses)   (Private)
-               to the LCD.
-               data is a 16-bit value bits 9-15 are not used, bit 8 is the 
-               register select, bits 0-7 is the character or command.
-               
-******************************************************************************/
-static void lcdWrite(INT16U data) {
-    INT8U c;
-    // Set/Reset RS
-    if((data & 0x0100) == 0x0100){
-        LCD_SET_RS(); //data write
-    }else{
-        LCD_CLR_RS(); //command write
-    }
-    
-    c = (INT8U)data;
-    // Write character/command to LCD
-    LCD_WR_DB((c>>4));
-    LCD_SET_E();
-    lcdDly500ns();
-    LCD_CLR_E();
-    lcdDly500ns();
-    lcdDly500ns();
-    LCD_WR_DB((c&0x0f));
-    LCD_SET_E();
-    lcdDly500ns();
-    LCD_CLR_E();
-    lcdDlyus(41);
-}
-
-
-/*************************************************************************
-  lcdClear() - Clears a buffer or layer                          (Private)
-*************************************************************************/
-static void lcdClear(LCD_BUFFER *buffer) {
-    INT8U row, col;
-    
-    // For each row...
-    for(row = 0; row < LCD_NUM_ROWS; row++) {
-        // For each column...
-        for(col = 0; col < LCD_NUM_COLS; col++) {
-
-            // Clear the character at that position
-            buffer->lcd_char[row][col] = LCD_CLEAR_BYTE;
-
-        }
-    }
-    
-}
-
-/********************************************************************
-** lcdMoveCursor(INT8U row, INT8U col)
-*
-*  FILENAME: LCD.c
-*
-*  PARAMETERS: row - Destination row (1 or 2).
-*              col - Destination column (1 - 16).
-*
-*  DESCRIPTION: Moves the cursor to [row,col].
-*
-*  RETURNS: None
-********************************************************************/
-static void lcdMoveCursor(INT8U row, INT8U col) {
-   lcdWrite(LCD_DD_RAM((lcdRowAddress[(row-1)]) + (col-1)));
-}
-
-/********************************************************************
-** LcdCursorDispMode(INT8U on, INT8U blink)
-*
-*  FILENAME: LCD.c
-*
-*  PARAMETERS: on - (Binary)Turn cursor on if TRUE, off if FALSE.
-*              blink - (Binary)Cursor blinks if TRUE.
-*
-*  DESCRIPTION: Changes LCD cursor state.
-*
-*  RETURNS: None
-********************************************************************/
-void LcdCursorDispMode(INT8U on, INT8U blink) {
-    lcdWrite(LCD_ON_OFF(1, on, blink));
-}
-
-/********************************************************************
-** LcdHideLayer(INT8U layer)
-*
-*  FILENAME: LcdLayered.c
-*
-*  PARAMETERS: layer - The layer to be hidden
-*
-*  DESCRIPTION: Hides the specified layer
-*
-*  RETURNS: None
-********************************************************************/
-void LcdHideLayer(INT8U layer){
-    lcdLayers[layer].hidden = 1;
-}
-
-
-/********************************************************************
-** LcdShowLayer(INT8U layer)
-*
-*  FILENAME: LcdLayered.c
-*
-*  PARAMETERS: layer - The layer to be shown
-*
-*  DESCRIPTION: Shows the specified layer
-*
-*  RETURNS: None
-********************************************************************/
-void LcdShowLayer(INT8U layer){
-    lcdLayers[layer].hidden = 0;
-}
-
-/********************************************************************
-** LcdToggleLayer(INT8U layer)
-*
-*  FILENAME: LcdLayered.c
-*
-*  PARAMETERS: layer - The layer to be toggled
-*
-*  DESCRIPTION: Toggles the specified layer
-*
-*  RETURNS: None
-********************************************************************/
-void LcdToggleLayer(INT8U layer){
-    if(lcdLayers[layer].hidden){
-        lcdLayers[layer].hidden = 0;
-    }else{
-        lcdLayers[layer].hidden = 1;
-    }
-}
-
-/*************************************************************************
-  lcdDlyus() - Blocks for the passed number of microseconds      (Private)
-*************************************************************************/
-static void lcdDlyus(INT16U us) {
-    INT16U cnt;
-    
-    for(cnt = 0; cnt <= us; cnt++) {
-        lcdDly500ns();
-        lcdDly500ns();
-    }
-
-}
-
-
-/********************************************************************
-** lcdDly500ns(void)
-*   Delays, at least, 500ns
-*   Designed for 120MHz or 150MHz clock.
- *  Tdly >= (66.5ns)i (at 150MHz)
- * Currently set to ~532ns with i=8.
- * TDM 01/20/2013
-********************************************************************/
-static void lcdDly500ns(void){
-    INT32U i;
-    for(i=0;i<8;i++){
-    }
-}
+/****************************************************************************************
+* LcdLayered.c - A MicroC/OS driver for for a Hitachi-type LCD Display
+*                                                                        
+*                This LCD driver implements the concept of layers.       
+*                This allows asynchronous application tasks to write to  
+*                a single LCD display without interfering with each      
+*                other.                                                  
+*                                                                        
+*                Requires the following be defined in app_cfg.h:         
+*                   APP_CFG_LCD_TASK_PRIO
+*                   APP_CFG_LCD_TASK_STK_SIZE
+*                                                                        
+*                It is derived from the work of Matthew Cohn, 2/26/2008
+*                
+*                Cursor code is derived from Keegan Morrow, 02/22/2013  
+*                                                                        
+* Todd Morton, 02/26/2013, First Revised Release
+* 01/22/2015, Added to git repo, general clean up. TDM
+* 02/03/2016, More cleanup. TDM
+* 01/13/2017 Changed name to LcdLayered (was LayeredLcd), fixed bugs. TDM
+* 01/18/2018 Changed to replace includes.h TDM
+* 02/01/2018 Brian Willis changed lcdLayeredTask() DB Bit from 3 to 4
+*
+*                After LcdInit() the LCD is written from a command queue
+*                clocked out by the PIT1 interrupt, so the LCD task only
+*                queues bytes and never waits on the display timing.
+*                PIT1 is reserved for this module.
+*
+*                With APP_CFG_LCD_BUSY_FLAG_EN the engine polls the busy
+*                flag instead of waiting the worst case command time.
+*                This needs R/W wired to LCD_RW_BIT, LcdInit() reads the
+*                address counter back and keeps the fixed delays if the
+*                display doesn't answer.
+*
+*                Each layer has a single writer task that owns its working
+*                copy in lcdLayers[]. Every LcdDisp*() call copies the
+*                layer into a spare slot and swaps it with the published
+*                slot in a short critical section, the LCD task swaps the
+*                published slot for the one it flattens from. Neither side
+*                ever blocks the other. LcdHide/Show/ToggleLayer() and
+*                LcdGlyphSet() may be called from any task.
+*
+*                With APP_CFG_LCD_EMU_EN every queued command is also fed
+*                to the LcdEmu.c model, giving a text snapshot of the
+*                display and the writes of each refresh.
+*****************************************************************************************
+* Header Files - Dependencies
+*****************************************************************************************/
+#include "MCUType.h"
+#include "app_cfg.h"
+#include "os.h"
+#include "LcdLayered.h"
+#include "K65TWR_GPIO.h"
+#include "CycleCnt.h"
+#if (APP_CFG_LCD_EMU_EN == DEF_ENABLED)
+#include "LcdEmu.h"
+#endif
+
+/*****************************************************************************************
+* LCD Port Defines 
+*****************************************************************************************/
+#define LCD_RS_BIT     0x2
+#define LCD_E_BIT      0x4
+#define LCD_DB_MASK    0x78
+#define LCD_PORT       GPIOD_PDOR
+#define LCD_PORT_DIR   GPIOD_PDDR
+#define INIT_BIT_DIR() (LCD_PORT_DIR |= (LCD_RS_BIT|LCD_E_BIT|LCD_DB_MASK))
+#define LCD_SET_RS()   GPIOD_PSOR = LCD_RS_BIT
+#define LCD_CLR_RS()   GPIOD_PCOR = LCD_RS_BIT
+#define LCD_SET_E()    GPIOD_PSOR = LCD_E_BIT
+#define LCD_CLR_E()    GPIOD_PCOR = LCD_E_BIT
+#define LCD_WR_DB(nib) (GPIOD_PDOR = (GPIOD_PDOR & ~LCD_DB_MASK)|((nib)<<3))
+#if (APP_CFG_LCD_BUSY_FLAG_EN == DEF_ENABLED)
+#define LCD_RW_BIT     0x1
+#define LCD_SET_RW()   GPIOD_PSOR = LCD_RW_BIT
+#define LCD_CLR_RW()   GPIOD_PCOR = LCD_RW_BIT
+#define LCD_DB_IN()    (LCD_PORT_DIR &= ~LCD_DB_MASK)
+#define LCD_DB_OUT()   (LCD_PORT_DIR |= LCD_DB_MASK)
+#define LCD_RD_DB()    ((INT8U)((GPIOD_PDIR & LCD_DB_MASK)>>3))
+#define LCD_BUSY_NIB   0x8     //DB7 in the high nibble of a status read
+#endif
+
+/*****************************************************************************************
+* LCD Write Engine Defines - PIT1 runs from the 60MHz bus clock
+*****************************************************************************************/
+#define LCD_Q_SIZE        64u          //Commands, must be a power of 2
+#define LCD_PIT_E_LDVAL   (60u-1u)     //1us for each E high and E low phase
+#define LCD_PIT_CMD_LDVAL (2460u-1u)   //41us for a command or data write
+#define LCD_PIT_CLR_LDVAL (99000u-1u)  //1.65ms for clear display and return home
+#define LCD_PIT_IRQ_PRIO  8u           //Below the DMA interrupt
+#define LCD_LONG_CMD(cmd) (((cmd) & 0x01FC) == 0)  //Clear display or return home
+#define LCD_BF_POLL_MAX   1000u        //4us polls, ~4ms, before giving up on the flag
+#define LCD_BF_TEST_ADDR  0x45         //DD RAM address read back to detect R/W
+
+typedef enum {LCD_ENG_HI_E_ON, LCD_ENG_HI_E_OFF, LCD_ENG_LO_E_ON, LCD_ENG_LO_E_OFF,
+              LCD_ENG_BF_HI_E_ON, LCD_ENG_BF_HI_RD, LCD_ENG_BF_LO_E_ON, LCD_ENG_BF_LO_RD} LCD_ENG_STATE;
+
+
+/*****************************************************************************************
+* LCD Defines                                                                            *
+*****************************************************************************************/
+// LCD Configuration
+#define LCD_NUM_ROWS   2
+#define LCD_NUM_COLS   16
+
+#define LCD_NUM_CELLS  (LCD_NUM_ROWS*LCD_NUM_COLS)
+
+#define LCD_ENABLE     0x04
+#define LCD_MIN_REFRESH_TICKS 20u  //20ms at the 1kHz tick, writes in between are merged
+#define LCD_CLEAR_BYTE 0x20    //SPACE is set as the transparent character
+
+// Word-wise (SWAR) compositing, 4 characters per 32 bit word
+#define LCD_NUM_WORDS  (LCD_NUM_CELLS/4)
+#define LCD_CLEAR_WORD 0x20202020U
+#define LCD_LOW7_BYTES 0x7F7F7F7FU
+#define LCD_HIGH_BYTES 0x80808080U
+typedef INT32U __attribute__((__may_alias__)) LCD_WORD;   //May alias lcd_char[][]
+
+// Dirty bitmap, one bit per cell, bit = row*LCD_NUM_COLS + col (0 based)
+#define LCD_CELL_BIT(row, col) ((INT32U)1 << (((row)*LCD_NUM_COLS) + (col)))
+#define LCD_ROW_CELLS(row)     ((INT32U)0xFFFF << ((row)*LCD_NUM_COLS))
+#define LCD_ALL_CELLS          0xFFFFFFFFU
+
+// Layer slots, at any time one is published, one is read by the LCD task and
+// one is the writer's spare
+#define LCD_NUM_SLOTS  3
+
+// LCD Cursor typedef
+typedef struct {
+    INT8U col;
+    INT8U row;
+    INT8U on;
+    INT8U blink;
+}LCD_CURSOR;
+
+// LCD layer and buffer typdedef
+typedef struct {
+    INT8C lcd_char[LCD_NUM_ROWS][LCD_NUM_COLS] __attribute__((aligned(4)));
+    LCD_CURSOR cursor;
+    INT32U dirty;      //Cells changed since the last flatten
+} LCD_BUFFER;
+
+/*************************************************************************
+  Private Local Functions
+*************************************************************************/
+static void lcdDlyus(INT16U us);
+static void lcdDly500ns(void);
+static void lcdWrite(INT16U data);
+static void lcdWriteWait(INT16U data);
+static void lcdEngRestart(INT32U ldval);
+#if (APP_CFG_LCD_BUSY_FLAG_EN == DEF_ENABLED)
+static INT8U lcdReadWait(void);
+#endif
+static void lcdClear(LCD_BUFFER *buffer);
+
+static void lcdFlattenLayers(LCD_BUFFER *dest_buffer);
+static void lcdWriteBuffer(LCD_BUFFER *buffer);
+static void lcdMoveCursor(INT8U row, INT8U col);
+static void lcdSignal(void);
+static void lcdPublish(INT8U layer);
+static void lcdRedraw(INT32U cells);
+static void lcdWriteGlyphs(void);
+
+/*************************************************************************
+  MicroC/OS Resources
+*************************************************************************/
+static OS_TCB lcdLayeredTaskTCB;
+static void lcdLayeredTask(void *p_arg);
+static CPU_STK lcdLayeredTaskStk[APP_CFG_LCD_TASK_STK_SIZE];
+
+/*************************************************************************
+  Global Variables
+*************************************************************************/
+// Stored Constants
+static const INT8U lcdRowAddress[LCD_NUM_ROWS] = {0x00, 0x40};
+
+// Static Globals
+static LCD_BUFFER lcdBuffer;
+static LCD_BUFFER lcdPreviousBuffer;
+static LCD_BUFFER lcdLayers[LCD_NUM_LAYERS];     //Working copies, owned by the writers
+static LCD_BUFFER lcdSlots[LCD_NUM_LAYERS][LCD_NUM_SLOTS];
+static INT8U lcdSlotSpare[LCD_NUM_LAYERS];       //Writer's, filled by lcdPublish()
+static INT8U lcdSlotReady[LCD_NUM_LAYERS];       //Last published
+static INT8U lcdSlotFront[LCD_NUM_LAYERS];       //LCD task's, flattened from
+static INT8U lcdSlotFresh[LCD_NUM_LAYERS];       //Ready slot not yet taken
+static INT8U lcdLayerHidden[LCD_NUM_LAYERS];
+static INT32U lcdRedrawCells;      //Cells to recompute regardless of layer writes
+// Command queue, lcdWrite() adds at lcdQHead, PIT1_IRQHandler() takes at lcdQTail
+static INT16U lcdQueue[LCD_Q_SIZE];
+static volatile INT8U lcdQHead;
+static volatile INT8U lcdQTail;
+static volatile INT8U lcdEngBusy;
+static LCD_ENG_STATE lcdEngState;
+static INT8U lcdBusyFlagMode;      //TRUE once LcdInit() has read the LCD back
+#if (APP_CFG_LCD_BUSY_FLAG_EN == DEF_ENABLED)
+static INT8U lcdBusyNib;           //Busy flag from the high nibble of the poll
+static INT16U lcdBusyPolls;
+#endif
+// Custom characters, lcdGlyphDirty has a bit per CG RAM row not yet written
+static INT8U lcdGlyphs[LCD_NUM_GLYPHS][LCD_GLYPH_ROWS];
+static INT8U lcdGlyphDirty[LCD_NUM_GLYPHS];
+static INT8U lcdGlyphLoaded;       //Bit per glyph set at least once
+// Open batches, one per writer task so one task's batch never holds
+// back another's changes. A layer has one writer, so a writer task per
+// layer at most.
+typedef struct{
+    OS_TCB *tcb;                   //Task with the batch open, 0 if free
+    INT8U depth;                   //LcdBegin() nesting, posts held while > 0
+    INT8U pending;                 //A layer changed during the batch
+    INT16U saved;                  //Posts held in the batch
+} LCD_BATCH;
+static LCD_BATCH lcdBatches[LCD_NUM_LAYERS];
+static INT32U lcdPostsSaved;       //Task wakes avoided since LcdInit()
+static LCD_BATCH *lcdBatchFind(void);
+#if (APP_CFG_LCD_BENCH_EN == DEF_ENABLED)
+static INT32U lcdFlattenCycles[LCD_NUM_CELLS+1];   //Worst case by changed cells
+#endif
+
+/*************************************************************************
+  LCD Command Macros
+*************************************************************************/
+/*                                                    R R D D D D D D D D
+                                                      / S B B B B B B B B
+                                                      W   7 6 5 4 3 2 1 0
+*/
+// Clear Display                                      0 0 0 0 0 0 0 0 0 1
+#define LCD_CLR_DISP()         (0x0001)      
+// Return Home                                        0 0 0 0 0 0 0 0 1 *
+#define LCD_CUR_HOME()         (0x0002)      
+// Entry Mode Set                                     0 0 0 0 0 0 0 1 ids
+#define LCD_ENTRY_MODE(id, s)  (0x0004                       \
+                                | ((INT16U)id ? 0x0002 : 0)  \
+                                | ((INT16U)s  ? 0x0001 : 0))
+// Display ON/OFF Control                             0 0 0 0 0 0 1 d c b
+#define LCD_ON_OFF(d, c, b)    (0x0008                       \
+                                | ((INT16U)d  ? 0x0004 : 0)  \
+                                | ((INT16U)c  ? 0x0002 : 0)  \
+                                | ((INT16U)b  ? 0x0001 : 0))
+// Cursor or Display Shift                            0 0 0 0 0 1 scrl* *
+#define LCD_SHIFT(sc, rl)      (0x0010                       \
+                                | ((INT16U)sc ? 0x0008 : 0)  \
+                                | ((INT16U)rl ? 0x0004 : 0))
+// Function Set                                       0 0 0 0 1 dln f * *
+#define LCD_FUNCTION(dl, n, f) (0x0020                       \
+                                | ((INT16U)dl ? 0x0010 : 0)  \
+                                | ((INT16U)n  ? 0x0008 : 0)  \
+                                | ((INT16U)f  ? 0x0004 : 0))
+// Set CG RAM Address                                 0 0 0 1 ----acg-----
+#define LCD_CG_RAM(acg)        (0x0040                       \
+                                | ((INT16U)acg  & 0x003F))
+// Set DD RAM Address                                 0 0 1 -----add------
+#define LCD_DD_RAM(add)        (0x0080                       \
+                                | (((INT16U)add)  & 0x007F))
+// Write Data to CG or DD RAM                         0 1 ------data------
+#define LCD_WRITE(data)        (0x0100                       \
+                                | ((INT16U)data & 0x00FF))
+                                                                       
+/******************************************************************************
+  lcdLayeredTask() - Handles writing to the LCD module      (Private Task)
+  
+        Queues the changed characters for PIT1_IRQHandler() to write, only
+        blocking if the command queue is full.
+******************************************************************************/
+static void lcdLayeredTask(void *p_arg) {
+    OS_ERR os_err;
+    
+    // Avoid compiler warning
+    (void)p_arg;
+    
+    OS_SEM_CTR extra_posts;
+    CPU_SR_ALLOC();
+
+    while(1) {
+    
+        // Wait for an lcd layer to be modified
+    	DB4_TURN_OFF();
+        OSTaskSemPend(0,OS_OPT_PEND_BLOCKING,(CPU_TS *)0, &os_err);
+    	DB4_TURN_ON();
+
+        // Posts that arrived since are covered by this flatten
+        extra_posts = OSTaskSemSet((OS_TCB *)0, 0, &os_err);
+        CPU_CRITICAL_ENTER();
+        lcdPostsSaved += extra_posts;
+        CPU_CRITICAL_EXIT();
+        
+        lcdWriteGlyphs();
+        lcdFlattenLayers(&lcdBuffer);
+        lcdWriteBuffer(&lcdBuffer);
+#if (APP_CFG_LCD_EMU_EN == DEF_ENABLED)
+        LcdEmuRefreshEnd();
+#endif
+
+        // Rate limit, anything written meanwhile goes out in one pass
+        OSTimeDly(LCD_MIN_REFRESH_TICKS, OS_OPT_TIME_DLY, &os_err);
+    }
+}
+
+/*************************************************************************
+  LcdCursor                                                       (Public)
+
+
+  DESCRIPTION: Sets the cursor position, blinking, and visibility.
+               Only from the layer's writer task, never blocks.
+
+  RETURNS: TRUE if no error, FALSE otherwise
+*************************************************************************/
+INT8U LcdCursor(INT8U row, INT8U col, INT8U layer, INT8U on, INT8U blink){
+    INT8U noerr = TRUE;
+
+    if ((layer < LCD_NUM_LAYERS) && (col <= LCD_NUM_COLS) && (row <= LCD_NUM_ROWS)){
+        lcdLayers[layer].cursor.col = col;
+        lcdLayers[layer].cursor.row = row;
+        if ( blink ){
+            lcdLayers[layer].cursor.blink = TRUE;
+        }else{
+            lcdLayers[layer].cursor.blink = FALSE;
+        }
+        if ( on ){
+            lcdLayers[layer].cursor.on = TRUE;
+        }else{
+            lcdLayers[layer].cursor.on = FALSE;
+        }
+        // We have modified a layer
+        lcdPublish(layer);
+    }else{
+        noerr = FALSE;
+    }
+
+    return(noerr);
+}
+/*************************************************************************
+  LcdBegin() - Starts a batch of layer writes                     (Public)
+
+               Layer writes until the matching LcdCommit() don't wake
+               the LCD task, so a burst of LcdDisp* calls costs one
+               flatten and one write pass. Batches may nest. The hold
+               is per calling task, writes from other tasks still post.
+*************************************************************************/
+void LcdBegin(void) {
+    LCD_BATCH *batch;
+    INT8U i;
+    CPU_SR_ALLOC();
+
+    CPU_CRITICAL_ENTER();
+    batch = lcdBatchFind();
+    for(i = 0; (i < LCD_NUM_LAYERS) && (batch == (LCD_BATCH *)0); i++) {
+        if(lcdBatches[i].tcb == (OS_TCB *)0) {
+            batch = &lcdBatches[i];
+            batch->tcb = OSTCBCurPtr;
+        }else{}
+    }
+    if(batch != (LCD_BATCH *)0) {
+        batch->depth++;
+    }else{}
+    CPU_CRITICAL_EXIT();
+    while(batch == (LCD_BATCH *)0){             /* Error Trap, more batching tasks than layers */
+    }
+}
+
+/*************************************************************************
+  LcdCommit() - Ends a batch of layer writes                      (Public)
+
+                Posts the LCD task once if anything changed since the
+                calling task's outermost LcdBegin().
+
+  RETURNS: LCD task posts saved by the batch, 0 from an inner commit
+*************************************************************************/
+INT16U LcdCommit(void) {
+    OS_ERR os_err;
+    INT8U post = FALSE;
+    INT16U saved = 0;
+    LCD_BATCH *batch;
+    CPU_SR_ALLOC();
+
+    CPU_CRITICAL_ENTER();
+    batch = lcdBatchFind();
+    if(batch != (LCD_BATCH *)0) {
+        batch->depth--;
+        if(batch->depth == 0) {
+            post = batch->pending;
+            saved = batch->saved;
+            if(saved > 0) {
+                saved--;                       //One post is still made
+                lcdPostsSaved += saved;
+            }else{}
+            batch->pending = FALSE;
+            batch->saved = 0;
+            batch->tcb = (OS_TCB *)0;
+        }else{}
+    }else{ //Commit without Begin
+    }
+    CPU_CRITICAL_EXIT();
+
+    if(post) {
+        (void)OSTaskSemPost(&lcdLayeredTaskTCB,OS_OPT_POST_NONE,&os_err);
+        while(os_err != OS_ERR_NONE){           /* Error Trap                        */
+        }
+    }else{}
+    return(saved);
+}
+
+/*************************************************************************
+  LcdPostsSaved() - LCD task wakes avoided by batching and by the (Public)
+                    minimum refresh interval since LcdInit()
+*************************************************************************/
+INT32U LcdPostsSaved(void) {
+    return(lcdPostsSaved);
+}
+
+/*************************************************************************
+  LcdBusyFlagMode() - TRUE if writes are paced by the LCD busy    (Public)
+                      flag, FALSE if by fixed worst case delays
+*************************************************************************/
+INT8U LcdBusyFlagMode(void) {
+    return(lcdBusyFlagMode);
+}
+
+/*************************************************************************
+  LcdGlyphSet() - Defines custom character glyph                  (Public)
+
+                  rows[0] is the top row, bits 4-0 of each row are the
+                  five pixels left to right. Only rows that differ from
+                  the glyph's current bitmap are marked for the LCD task
+                  to rewrite, so setting the same bitmap again costs no
+                  LCD writes. Show it with LCD_GLYPH_CHAR(glyph).
+
+                  Compares and copies in a critical section, never blocks.
+                  If a row changed, marks it in lcdGlyphDirty and calls
+                  lcdSignal(). The LCD task writes it to CG RAM with
+                  lcdWriteGlyphs(), and cells showing the glyph change
+                  with it, so nothing is added to lcdRedrawCells.
+
+  RETURNS: TRUE if no error, FALSE if glyph is out of range
+*************************************************************************/
+INT8U LcdGlyphSet(INT8U glyph, const INT8U *rows) {
+    INT8U row, bits;
+    INT8U changed = 0;
+    INT8U noerr = TRUE;
+    CPU_SR_ALLOC();
+
+    if(glyph < LCD_NUM_GLYPHS) {
+        CPU_CRITICAL_ENTER();
+
+        // CG RAM is random at power up, so write every row the first time
+        if((lcdGlyphLoaded & (1u << glyph)) == 0) {
+            lcdGlyphLoaded |= (INT8U)(1u << glyph);
+            changed = 0xFF;
+        }else{}
+        for(row = 0; row < LCD_GLYPH_ROWS; row++) {
+            bits = rows[row] & 0x1F;
+            if(lcdGlyphs[glyph][row] != bits) {
+                lcdGlyphs[glyph][row] = bits;
+                changed |= (INT8U)(1u << row);
+            }else{}
+        }
+        lcdGlyphDirty[glyph] |= changed;
+        CPU_CRITICAL_EXIT();
+
+        if(changed != 0) {
+            lcdSignal();
+        }else{}
+    }else{
+        noerr = FALSE;
+    }
+    return(noerr);
+}
+
+/*************************************************************************
+  lcdWriteGlyphs() - Writes changed glyph rows to CG RAM         (Private)
+
+        Takes a copy of the dirty rows in a critical section, then queues a
+        CG RAM address only where the rows are not consecutive. The
+        caller's lcdWriteBuffer() sets a DD RAM address before its first
+        character, so the address counter is left in CG RAM safely.
+*************************************************************************/
+static void lcdWriteGlyphs(void) {
+    INT8U glyph, row, addr, next_addr;
+    INT8U dirty[LCD_NUM_GLYPHS];
+    INT8U rows[LCD_NUM_GLYPHS][LCD_GLYPH_ROWS];
+    CPU_SR_ALLOC();
+
+    CPU_CRITICAL_ENTER();
+    for(glyph = 0; glyph < LCD_NUM_GLYPHS; glyph++) {
+        dirty[glyph] = lcdGlyphDirty[glyph];
+        lcdGlyphDirty[glyph] = 0;
+        if(dirty[glyph] != 0) {
+            for(row = 0; row < LCD_GLYPH_ROWS; row++) {
+                rows[glyph][row] = lcdGlyphs[glyph][row];
+            }
+        }else{}
+    }
+    CPU_CRITICAL_EXIT();
+
+    next_addr = 0xFF;
+    for(glyph = 0; glyph < LCD_NUM_GLYPHS; glyph++) {
+        for(row = 0; (dirty[glyph] != 0) && (row < LCD_GLYPH_ROWS); row++) {
+            if((dirty[glyph] & (1u << row)) != 0) {
+                addr = (glyph * LCD_GLYPH_ROWS) + row;
+                if(addr != next_addr) {     //Address counter auto increments
+                    lcdWrite(LCD_CG_RAM(addr));
+                }else{}
+                lcdWrite(LCD_WRITE(rows[glyph][row]));
+                next_addr = addr + 1;
+            }else{}
+        }
+    }
+}
+
+/*************************************************************************
+  lcdSignal() - Tells the LCD task a layer changed               (Private)
+
+                Held until LcdCommit() while the calling task has a
+                batch open.
+*************************************************************************/
+static void lcdSignal(void) {
+    OS_ERR os_err;
+    INT8U held = FALSE;
+    LCD_BATCH *batch;
+    CPU_SR_ALLOC();
+
+    CPU_CRITICAL_ENTER();
+    batch = lcdBatchFind();
+    if(batch != (LCD_BATCH *)0) {
+        batch->pending = TRUE;
+        batch->saved++;
+        held = TRUE;
+    }else{}
+    CPU_CRITICAL_EXIT();
+
+    if(held == FALSE) {
+        (void)OSTaskSemPost(&lcdLayeredTaskTCB,OS_OPT_POST_NONE,&os_err);
+        while(os_err != OS_ERR_NONE){           /* Error Trap                        */
+        }
+    }else{}
+}
+
+/*************************************************************************
+  lcdBatchFind() - The calling task's open batch, 0 if it has   (Private)
+                   none. Call in a critical section.
+*************************************************************************/
+static LCD_BATCH *lcdBatchFind(void) {
+    LCD_BATCH *batch = (LCD_BATCH *)0;
+    INT8U i;
+
+    for(i = 0; i < LCD_NUM_LAYERS; i++) {
+        if(lcdBatches[i].tcb == OSTCBCurPtr) {
+            batch = &lcdBatches[i];
+        }else{}
+    }
+    return(batch);
+}
+
+/*************************************************************************
+  lcdPublish() - Hands the writer's copy of a layer to the LCD   (Private)
+                 task and signals it
+
+        The copy is made into the spare slot outside the critical section
+        since only the writer touches the spare. The swap then makes it
+        the ready slot. If the LCD task has not taken the previous ready
+        slot its dirty cells are carried over, they were never flattened.
+*************************************************************************/
+static void lcdPublish(INT8U layer) {
+    LCD_BUFFER *spare;
+    INT8U slot;
+    CPU_SR_ALLOC();
+
+    spare = &lcdSlots[layer][lcdSlotSpare[layer]];
+    *spare = lcdLayers[layer];
+    lcdLayers[layer].dirty = 0;
+
+    CPU_CRITICAL_ENTER();
+    if(lcdSlotFresh[layer]) {
+        spare->dirty |= lcdSlots[layer][lcdSlotReady[layer]].dirty;
+    }else{}
+    slot = lcdSlotReady[layer];
+    lcdSlotReady[layer] = lcdSlotSpare[layer];
+    lcdSlotSpare[layer] = slot;
+    lcdSlotFresh[layer] = TRUE;
+    CPU_CRITICAL_EXIT();
+
+    lcdSignal();
+}
+
+/*************************************************************************
+  lcdRedraw() - Marks cells for the next flatten and signals the (Private)
+                LCD task, for changes that are not layer writes
+*************************************************************************/
+static void lcdRedraw(INT32U cells) {
+    CPU_SR_ALLOC();
+
+    CPU_CRITICAL_ENTER();
+    lcdRedrawCells |= cells;
+    CPU_CRITICAL_EXIT();
+
+    lcdSignal();
+}
+
+/*************************************************************************
+  LcdDispClear() - Clears a layer                                 (Public)   
+
+                   Only from the layer's writer task, never blocks
+                   Publishes the layer to the LCD task
+*************************************************************************/
+void LcdDispClear(INT8U layer) {
+    LCD_BUFFER *llayer = &lcdLayers[layer];
+
+
+    lcdClear(llayer);
+    llayer->dirty = LCD_ALL_CELLS;
+
+    // Hand the changed layer to the LCD task
+    lcdPublish(layer);
+}
+
+
+/*************************************************************************
+  LcdDispClrLine() - Clears a line of a layer                     (Public)   
+
+                     Only from the layer's writer task, never blocks
+                     Publishes the layer to the LCD task
+*************************************************************************/
+void LcdDispClrLine(INT8U row, INT8U layer) {
+    INT8U col;
+    
+    LCD_BUFFER *llayer = &lcdLayers[layer];
+    
+    
+    // For each column...
+    for(col = 0; col < LCD_NUM_COLS; col++) {
+
+        // Clear the character at that position
+        llayer->lcd_char[row-1][col] = LCD_CLEAR_BYTE;
+    }
+    llayer->dirty |= LCD_ROW_CELLS(row-1);
+    
+    // Hand the changed layer to the LCD task
+    lcdPublish(layer);
+}
+
+
+/*************************************************************************
+  LcdDispString() - Writes a null terminated string to a layer    (Public)
+
+                    Only from the layer's writer task, never blocks
+                    Publishes the layer to the LCD task
+*************************************************************************/
+void LcdDispString(INT8U row,
+                   INT8U col,
+                   INT8U layer,
+                   const INT8C *string) {
+
+    INT8U cnt, row_index, col_index;
+    LCD_BUFFER *llayer = &lcdLayers[layer];
+
+    row_index = row - 1;
+    col_index = col - 1;
+    
+    
+    // Iterate through the string until we reach a null
+    for(cnt = 0; string[cnt] != 0x00; cnt++) {
+    
+        if((col_index+cnt) < LCD_NUM_COLS){ // not at end of row
+            // Copy from the passed paramater to the layer
+            llayer->lcd_char[row_index][col_index+cnt] = string[cnt];
+            llayer->dirty |= LCD_CELL_BIT(row_index, col_index+cnt);
+        }else{ //outside buffer
+        }
+    }
+    
+    // Hand the changed layer to the LCD task
+    lcdPublish(layer);
+}
+
+
+
+/*************************************************************************
+  LcdDispChar() - Writes a character to a layer                   (Public)
+
+                  Only from the layer's writer task, never blocks
+                  Publishes the layer to the LCD task
+*************************************************************************/
+void LcdDispChar(INT8U row,
+                 INT8U col,
+                 INT8U layer,
+                 INT8C character) {
+    INT8U row_index, col_index;
+    LCD_BUFFER *llayer = &lcdLayers[layer];
+
+    row_index = row - 1;
+    col_index = col - 1;
+    
+    if(col_index < LCD_NUM_COLS){
+    
+        // Copy from the passed paramater to the layer
+        llayer->lcd_char[row_index][col_index] = character;
+        llayer->dirty |= LCD_CELL_BIT(row_index, col_index);
+    
+        // Hand the changed layer to the LCD task
+        lcdPublish(layer);
+    }else{ //outside layer
+    }
+}
+
+
+
+/*************************************************************************
+  LcdDispByte - Writes the ASCII representation of a byte to a    (Public)
+                layer in hex
+
+                Only from the layer's writer task, never blocks
+                Publishes the layer to the LCD task
+*************************************************************************/
+void LcdDispByte(INT8U row, INT8U col, INT8U layer, INT8U byte) {
+    INT8U row_index, col_index;
+    LCD_BUFFER *llayer = &lcdLayers[layer];
+    
+    // Convert row / col index 1 to index 0
+    row_index = row - 1;
+    col_index = col - 1;
+    
+    if(col < LCD_NUM_COLS){
+
+        llayer->lcd_char[row_index][col_index+0] = (byte >> 4);   // MSB
+        llayer->lcd_char[row_index][col_index+1] = (byte & 0x0F); // LSB
+    
+        // Convert MSB to ASCII character
+        llayer->lcd_char[row_index][col_index+0] +=
+            (llayer->lcd_char[row_index][col_index+0] <= 9 ? '0' : 'A' - 10);
+
+        // Convert LSB to ASCII character
+        llayer->lcd_char[row_index][col_index+1] +=
+            (llayer->lcd_char[row_index][col_index+1] <= 9 ? '0' : 'A' - 10);
+
+        llayer->dirty |= LCD_CELL_BIT(row_index, col_index+0)
+                       | LCD_CELL_BIT(row_index, col_index+1);
+
+        // Hand the changed layer to the LCD task
+        lcdPublish(layer);
+    }else{ //outside layer
+    }
+}
+
+
+/*************************************************************************
+  LcdDispDecByte - Writes the ASCII representation of a byte to a (Public)
+                   layer in decimal
+
+                   Only from the layer's writer task, never blocks
+                   Publishes the layer to the LCD task
+*************************************************************************/
+void LcdDispDecByte(INT8U row,
+                    INT8U col,
+                    INT8U layer,
+                    INT8U byte,
+                    INT8U lzeros) {
+    
+    INT8U row_index, col_index, hunds, tens, ones;
+    LCD_BUFFER *llayer = &lcdLayers[layer];
+    
+    if((col + 1) < LCD_NUM_COLS){
+        // Convert row / col index 1 to index 0
+        row_index = row - 1;
+        col_index = col - 1;
+    
+        hunds = byte / 100;
+        tens = (byte / 10) % 10;
+        ones = byte % 10;
+    
+
+        if(lzeros == 1 || hunds > 0) {
+            llayer->lcd_char[row_index][col_index+0] = hunds; // Hundreds
+            llayer->lcd_char[row_index][col_index+0] += '0';  //  --> ASCII
+        }
+
+        if(lzeros == 1 || hunds > 0 || tens > 0) {
+            llayer->lcd_char[row_index][col_index+1] = tens;  // Tens
+            llayer->lcd_char[row_index][col_index+1] += '0';  //  --> ASCII
+        }
+    
+        llayer->lcd_char[row_index][col_index+2] = ones;      // Ones
+        llayer->lcd_char[row_index][col_index+2] += '0';      //  --> ASCII
+        llayer->dirty |= LCD_CELL_BIT(row_index, col_index+0)
+                       | LCD_CELL_BIT(row_index, col_index+1)
+                       | LCD_CELL_BIT(row_index, col_index+2);
+        
+
+        // Hand the changed layer to the LCD task
+        lcdPublish(layer);
+    }else{ //outside layer
+    }
+}
+
+/*************************************************************************
+  LcdDispTime - Writes a time to a layer                          (Public)
+
+                Only from the layer's writer task, never blocks
+                Publishes the layer to the LCD task
+*************************************************************************/
+void LcdDispTime(INT8U row,
+                 INT8U col,
+                  INT8U layer,
+                 INT8U hrs,
+                 INT8U mins,
+                 INT8U secs) {
+    INT8U row_index, col_index;
+    LCD_BUFFER *llayer = &lcdLayers[layer];
+
+    if((col + 6) < LCD_NUM_COLS){
+        // Convert row / col index 1 to index 0
+        row_index = row - 1;
+        col_index = col - 1;
+
+    
+    
+
+        llayer->lcd_char[row_index][col_index+0] = hrs / 10 + '0';
+        llayer->lcd_char[row_index][col_index+1] = hrs % 10 + '0';
+
+        llayer->lcd_char[row_index][col_index+2] = ':';
+
+        llayer->lcd_char[row_index][col_index+3] = mins / 10 + '0';
+        llayer->lcd_char[row_index][col_index+4] = mins % 10 + '0';
+
+        llayer->lcd_char[row_index][col_index+5] = ':';
+
+        llayer->lcd_char[row_index][col_index+6] = secs / 10 + '0';
+        llayer->lcd_char[row_index][col_index+7] = secs % 10 + '0';
+        llayer->dirty |= (INT32U)0xFF << ((row_index*LCD_NUM_COLS) + col_index);
+    
+           
+        // Hand the changed layer to the LCD task
+        lcdPublish(layer);
+    }else{ //outside layer
+    }
+}
+
+
+/******************************************************************************
+  LcdInit() - Initializes the LCD                                 (Public)
+
+        Initializes the LCD hardware, sets up our semaphores/mutexes/task,
+        clears all of our buffers and layers.  This needs to be run before
+        any other function that accesses the LCD.
+******************************************************************************/
+void LcdInit(void) {
+    INT8U layer_cnt, slot;
+    OS_ERR os_err;
+    
+    // Create task
+    OSTaskCreate((OS_TCB     *)&lcdLayeredTaskTCB,
+                (CPU_CHAR   *)"Layered LCD Task",
+                (OS_TASK_PTR ) lcdLayeredTask,
+                (void       *) 0,
+                (OS_PRIO     ) APP_CFG_LCD_TASK_PRIO,
+                (CPU_STK    *)&lcdLayeredTaskStk[0],
+                (CPU_STK     )(APP_CFG_LCD_TASK_STK_SIZE / 10u),
+                (CPU_STK_SIZE) APP_CFG_LCD_TASK_STK_SIZE,
+                (OS_MSG_QTY  ) 0,
+                (OS_TICK     ) 0,
+                (void       *) 0,
+                (OS_OPT      )(OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR),
+                (OS_ERR     *)&os_err);
+    while(os_err != OS_ERR_NONE){           /* Error Trap                        */
+    }
+
+    // Perform LCD hardware initialisation
+    SIM_SCGC5 |= SIM_SCGC5_PORTD_MASK;              /* Enable clock gate for PORTD */
+    PORTD_PCR1=(0|PORT_PCR_MUX(1));
+    PORTD_PCR2=(0|PORT_PCR_MUX(1));
+    PORTD_PCR3=(0|PORT_PCR_MUX(1));
+    PORTD_PCR4=(0|PORT_PCR_MUX(1));
+    PORTD_PCR5=(0|PORT_PCR_MUX(1));
+    PORTD_PCR6=(0|PORT_PCR_MUX(1));
+    INIT_BIT_DIR();
+#if (APP_CFG_LCD_BUSY_FLAG_EN == DEF_ENABLED)
+    // R/W output low, pull ups so an LCD that can't drive the bus reads 0xFF
+    PORTD_PCR0=(0|PORT_PCR_MUX(1));
+    LCD_CLR_RW();
+    LCD_PORT_DIR |= LCD_RW_BIT;
+    PORTD_PCR3 |= (PORT_PCR_PE_MASK|PORT_PCR_PS_MASK);
+    PORTD_PCR4 |= (PORT_PCR_PE_MASK|PORT_PCR_PS_MASK);
+    PORTD_PCR5 |= (PORT_PCR_PE_MASK|PORT_PCR_PS_MASK);
+    PORTD_PCR6 |= (PORT_PCR_PE_MASK|PORT_PCR_PS_MASK);
+#endif
+    LCD_CLR_E(); 
+    LCD_SET_RS();           /*Data select unless in LcdWrCmd()  */
+    lcdDlyus(15000);           /* LCD requires 15ms delay at powerup */
+#if (APP_CFG_LCD_EMU_EN == DEF_ENABLED)
+    LcdEmuReset();          /* The 8-bit reset nibbles below are not fed */
+#endif
+   
+    LCD_CLR_RS();           /*Send first command for RESET sequence*/
+    LCD_WR_DB(0x3);
+    LCD_SET_E();
+    lcdDly500ns();
+    LCD_CLR_E();
+    lcdDlyus(4200);            /*Wait >4.1ms */
+  
+    LCD_WR_DB(0x3);         /*Repeat */
+    LCD_SET_E();
+    lcdDly500ns();
+    LCD_CLR_E();
+    lcdDlyus(101);            /*Wait >100us */
+  
+    LCD_WR_DB(0x3);         /* Repeat */
+    LCD_SET_E();
+    lcdDly500ns();
+    LCD_CLR_E();
+    lcdDlyus(41);           /*Wait >40us*/
+  
+    LCD_WR_DB(0x2);         /*Send last command for RESET sequence*/
+    LCD_SET_E();
+    lcdDly500ns();
+    LCD_CLR_E();
+    lcdDlyus(41);
+  
+    lcdWriteWait(LCD_FUNCTION(0, 1, 0));     /*Send command for 4-bit mode */
+    lcdWriteWait(LCD_ENTRY_MODE(1, 0)); // Increment, no shift
+    lcdWriteWait(LCD_ON_OFF(1, 0, 0));  // LCD on, cursor off, blink off
+    lcdWriteWait(LCD_CLR_DISP());       // Clear display
+    lcdDlyus(1650);
+#if (APP_CFG_LCD_BUSY_FLAG_EN == DEF_ENABLED)
+    // Use the busy flag only if the address counter reads back
+    lcdWriteWait(LCD_DD_RAM(LCD_BF_TEST_ADDR));
+    if(lcdReadWait() == LCD_BF_TEST_ADDR){
+        lcdBusyFlagMode = TRUE;
+    }else{ //Write only wiring, keep the fixed delays
+        lcdBusyFlagMode = FALSE;
+    }
+#else
+    lcdBusyFlagMode = FALSE;
+#endif
+    lcdWriteWait(LCD_DD_RAM(0x0000));   // Reset cursor
+#if (APP_CFG_LCD_EMU_EN == DEF_ENABLED)
+    LcdEmuRefreshEnd();                 // Init commands count as one refresh
+#endif
+    
+    
+    // Clear all of our layers
+    for(layer_cnt = 0; layer_cnt < LCD_NUM_LAYERS; layer_cnt++) {
+        lcdClear(&lcdLayers[layer_cnt]);
+        for(slot = 0; slot < LCD_NUM_SLOTS; slot++) {
+            lcdClear(&lcdSlots[layer_cnt][slot]);
+        }
+        lcdSlotSpare[layer_cnt] = 0;
+        lcdSlotReady[layer_cnt] = 1;
+        lcdSlotFront[layer_cnt] = 2;
+        lcdSlotFresh[layer_cnt] = FALSE;
+    }
+    
+    // Clear the current buffer
+    // and the previous buffer
+    lcdClear(&lcdBuffer);
+    lcdClear(&lcdPreviousBuffer);
+
+    // Set up PIT1 for the write engine, it runs only while commands are queued
+    SIM_SCGC6 |= SIM_SCGC6_PIT_MASK;
+    PIT_MCR = PIT_MCR_MDIS(0);
+    PIT_TCTRL1 = 0;
+    PIT_TFLG1 = PIT_TFLG_TIF_MASK;
+    lcdQHead = 0;
+    lcdQTail = 0;
+    lcdEngBusy = FALSE;
+    lcdEngState = LCD_ENG_HI_E_ON;
+    NVIC_SetPriority(PIT1_IRQn, LCD_PIT_IRQ_PRIO);
+    NVIC_ClearPendingIRQ(PIT1_IRQn);
+    NVIC_EnableIRQ(PIT1_IRQn);
+#if (APP_CFG_LCD_BENCH_EN == DEF_ENABLED)
+    CycleCntInit();
+#endif
+}
+
+
+/*************************************************************************
+  lcdFlattenLayers() - Combines the layers onto *dest_buffer      (Private)
+
+        Each layer's latest published slot is taken first, so the layers
+        are read from slots no writer touches. The layer with the lowest
+        index will be on the bottom, the layer with the highest index
+        will be on the top.  Treats the
+        character defined as LCD_CLEAR_BYTE as a transparent byte.
+
+        Only the 4 character words with a cell marked dirty in any layer
+        since the last call are recomputed, dest_buffer keeps the rest from
+        the last call. The cursor is always recomputed.
+
+        Each word is composited 4 characters at a time: x = word ^ 0x20..
+        has a zero byte exactly where the layer is transparent, and
+        ((x & 0x7F..) + 0x7F..) | x sets the high bit of every non-zero
+        byte without carrying between bytes. Spreading those bits into
+        0xFF bytes gives the mask of characters the layer covers.
+
+        LCD task only, or before it first runs.
+*************************************************************************/
+static void lcdFlattenLayers(LCD_BUFFER *dest_buffer) {
+    
+    INT8U layer, word, slot;
+    INT32U dirty;
+    INT32U out, src, mask;
+    LCD_WORD *dest_words = (LCD_WORD *)&dest_buffer->lcd_char[0][0];
+    const LCD_WORD *src_words;
+    LCD_BUFFER *src_layers[LCD_NUM_LAYERS];
+    INT8U hidden[LCD_NUM_LAYERS];
+    CPU_SR_ALLOC();
+#if (APP_CFG_LCD_BENCH_EN == DEF_ENABLED)
+    INT32U start;
+    INT32U bits;
+    INT8U cells = 0;
+
+    start = CYCLE_CNT_GET();
+#endif
+
+    // Take the newest slot of each layer and collect the changed cells
+    CPU_CRITICAL_ENTER();
+    dirty = lcdRedrawCells;
+    lcdRedrawCells = 0;
+    for(layer = 0; layer < LCD_NUM_LAYERS; layer++) {
+        if(lcdSlotFresh[layer]) {
+            slot = lcdSlotFront[layer];
+            lcdSlotFront[layer] = lcdSlotReady[layer];
+            lcdSlotReady[layer] = slot;
+            lcdSlotFresh[layer] = FALSE;
+        }else{}
+        hidden[layer] = lcdLayerHidden[layer];
+    }
+    CPU_CRITICAL_EXIT();
+    for(layer = 0; layer < LCD_NUM_LAYERS; layer++) {
+        src_layers[layer] = &lcdSlots[layer][lcdSlotFront[layer]];
+        dirty |= src_layers[layer]->dirty;
+        src_layers[layer]->dirty = 0;
+    }
+
+#if (APP_CFG_LCD_BENCH_EN == DEF_ENABLED)
+    for(bits = dirty; bits != 0; bits &= bits - 1) {
+        cells++;
+    }
+#endif
+
+    // For each word with a changed cell...
+    for(word = 0; word < LCD_NUM_WORDS; word++) {
+        if(((dirty >> (word*4)) & 0xF) != 0) {
+            out = LCD_CLEAR_WORD;
+
+            // Blend each visible layer over the ones below it
+            for(layer = 0; layer < LCD_NUM_LAYERS; layer++) {
+                if(hidden[layer] == 0) {
+                    src_words = (const LCD_WORD *)&src_layers[layer]->lcd_char[0][0];
+                    src = src_words[word];
+                    mask = src ^ LCD_CLEAR_WORD;
+                    mask = ((((mask & LCD_LOW7_BYTES) + LCD_LOW7_BYTES) | mask)
+                            & LCD_HIGH_BYTES) >> 7;
+                    mask *= 0xFF;
+                    out = (out & ~mask) | (src & mask);
+                }else{ //Do nothing - layer is hidden
+                }
+            }
+            dest_words[word] = out;
+        }else{ //No layer changed these 4 cells
+        }
+    }
+
+    // Set the destination buffer cursor to false initially
+    dest_buffer->cursor.on = FALSE;
+    dest_buffer->cursor.blink = FALSE;
+
+    // The top visible layer sets the cursor
+    for(layer = 0; layer < LCD_NUM_LAYERS; layer++) {
+        if(hidden[layer] == 0) {
+            dest_buffer->cursor = src_layers[layer]->cursor;
+        }else{ //Do nothing - layer is hidden
+        }
+    } // layer
+
+#if (APP_CFG_LCD_BENCH_EN == DEF_ENABLED)
+    start = CYCLE_CNT_GET() - start;
+    if(start > lcdFlattenCycles[cells]){
+        lcdFlattenCycles[cells] = start;
+    }else{}
+#endif
+}
+
+
+/*************************************************************************
+  lcdWriteBuffer() - Sends an LCD_BUFFER buffer to lcdWrite()    (Private)
+  
+        The previous buffer lcdPreviousBuffer is a global variable
+        containing a copy of the actual contents of the LCD module.  By 
+        using the lcdPreviousBuffer and repos_flag, we are able to only
+        write bytes that have changed.
+                                                           
+                     Blocks only while the command queue is full
+*************************************************************************/
+static void lcdWriteBuffer(LCD_BUFFER *buffer) {
+    INT8U row, col, repos_flag;
+    
+    // For each row...
+    for(row = 0; row < LCD_NUM_ROWS; row++) {
+    
+        // Set our cursor to the beginning of the row
+        lcdWrite(LCD_DD_RAM(lcdRowAddress[row]));
+        repos_flag = 0;
+        
+        // For each column...
+        for(col = 0; col < LCD_NUM_COLS; col++) {
+
+            // If the character at the current position has changed...
+            if(lcdPreviousBuffer.lcd_char[row][col]
+                != buffer->lcd_char[row][col]) {
+                
+                // If we need to reposition, do that now
+                if(repos_flag == 1) {
+                    lcdWrite(LCD_DD_RAM((lcdRowAddress[row] + col)));
+                    repos_flag = 0;
+                }
+            
+                // Write the character to the LCD
+                lcdWrite(LCD_WRITE(buffer->lcd_char[row][col]));
+             
+                // And update the previous buffer
+                lcdPreviousBuffer.lcd_char[row][col] =
+                    buffer->lcd_char[row][col];
+            } else {
+                // Otherwise we don't write the character... but we need
+                //   to set the reposition flag
+                
+                repos_flag = 1;
+            }
+            
+        
+        }
+    }
+    // At the end setup the cursor
+    lcdMoveCursor(buffer->cursor.row,buffer->cursor.col);
+    LcdCursorDispMode(buffer->cursor.on, buffer->cursor.blink);
+
+}
+
+/******************************************************************************
+  lcdWrite() - Queues a command (both data and control busses)   (Private)
+               for the LCD.
+               data is a 16-bit value bits 9-15 are not used, bit 8 is the 
+               register select, bits 0-7 is the character or command.
+
+               Starts PIT1 if the engine is idle. Waits a tick at a time
+               while the queue is full. Task level only.
+******************************************************************************/
+static void lcdWrite(INT16U data) {
+    OS_ERR os_err;
+    INT8U start = FALSE;
+    CPU_SR_ALLOC();
+
+    while(((lcdQHead + 1u) & (LCD_Q_SIZE - 1u)) == lcdQTail){
+        OSTimeDly(1, OS_OPT_TIME_DLY, &os_err);
+    }
+#if (APP_CFG_LCD_EMU_EN == DEF_ENABLED)
+    LcdEmuFeed(data);
+#endif
+
+    CPU_CRITICAL_ENTER();
+    lcdQueue[lcdQHead] = data;
+    lcdQHead = (lcdQHead + 1u) & (LCD_Q_SIZE - 1u);
+    if(lcdEngBusy == FALSE){
+        lcdEngBusy = TRUE;
+        start = TRUE;
+    }else{}
+    CPU_CRITICAL_EXIT();
+
+    if(start){
+        lcdEngState = LCD_ENG_HI_E_ON;
+        lcdEngRestart(LCD_PIT_E_LDVAL);
+    }else{}
+}
+
+/******************************************************************************
+  PIT1_IRQHandler() - LCD write engine                           (Public ISR)
+
+        Each queued command takes four interrupts: the high nibble is put
+        out with E raised, E is dropped, then the same for the low nibble.
+        After the last phase the timer waits out the command's execution
+        time before the next command, and stops once the queue is empty.
+        Does not call the kernel, so no OSIntEnter()/OSIntExit().
+
+        In busy flag mode the wait is replaced by status reads, two E
+        pulses each with R/W high and the data pins as inputs, repeated
+        until the flag clears. If it never clears the engine drops back
+        to the fixed delays for good.
+******************************************************************************/
+void PIT1_IRQHandler(void) {
+    INT16U data;
+
+    PIT_TFLG1 = PIT_TFLG_TIF_MASK;
+    switch(lcdEngState) {
+        case LCD_ENG_HI_E_ON:
+            if(lcdQTail == lcdQHead) {                  //Queue empty, stop
+                PIT_TCTRL1 = 0;
+                lcdEngBusy = FALSE;
+            }else{
+                data = lcdQueue[lcdQTail];
+                if((data & 0x0100) == 0x0100){
+                    LCD_SET_RS(); //data write
+                }else{
+                    LCD_CLR_RS(); //command write
+                }
+                LCD_WR_DB(((INT8U)data>>4));
+                LCD_SET_E();
+                lcdEngState = LCD_ENG_HI_E_OFF;
+                lcdEngRestart(LCD_PIT_E_LDVAL);
+            }
+            break;
+        case LCD_ENG_HI_E_OFF:
+            LCD_CLR_E();
+            lcdEngState = LCD_ENG_LO_E_ON;
+            lcdEngRestart(LCD_PIT_E_LDVAL);
+            break;
+        case LCD_ENG_LO_E_ON:
+            LCD_WR_DB(((INT8U)lcdQueue[lcdQTail]&0x0f));
+            LCD_SET_E();
+            lcdEngState = LCD_ENG_LO_E_OFF;
+            lcdEngRestart(LCD_PIT_E_LDVAL);
+            break;
+#if (APP_CFG_LCD_BUSY_FLAG_EN == DEF_ENABLED)
+        case LCD_ENG_BF_HI_E_ON:
+            LCD_SET_E();
+            lcdEngState = LCD_ENG_BF_HI_RD;
+            lcdEngRestart(LCD_PIT_E_LDVAL);
+            break;
+        case LCD_ENG_BF_HI_RD:
+            lcdBusyNib = LCD_RD_DB() & LCD_BUSY_NIB;
+            LCD_CLR_E();
+            lcdEngState = LCD_ENG_BF_LO_E_ON;
+            lcdEngRestart(LCD_PIT_E_LDVAL);
+            break;
+        case LCD_ENG_BF_LO_E_ON:
+            LCD_SET_E();                                //Low nibble is the address, unused
+            lcdEngState = LCD_ENG_BF_LO_RD;
+            lcdEngRestart(LCD_PIT_E_LDVAL);
+            break;
+        case LCD_ENG_BF_LO_RD:
+            LCD_CLR_E();
+            lcdBusyPolls++;
+            if((lcdBusyNib != 0) && (lcdBusyPolls < LCD_BF_POLL_MAX)){
+                lcdEngState = LCD_ENG_BF_HI_E_ON;       //Still busy, poll again
+            }else{
+                if(lcdBusyNib != 0){                    //Flag stuck, stop using it
+                    lcdBusyFlagMode = FALSE;
+                }else{}
+                LCD_CLR_RW();
+                LCD_DB_OUT();
+                lcdEngState = LCD_ENG_HI_E_ON;
+            }
+            lcdEngRestart(LCD_PIT_E_LDVAL);
+            break;
+#endif
+        case LCD_ENG_LO_E_OFF:
+        default:
+            LCD_CLR_E();
+            data = lcdQueue[lcdQTail];
+            lcdQTail = (lcdQTail + 1u) & (LCD_Q_SIZE - 1u);
+#if (APP_CFG_LCD_BUSY_FLAG_EN == DEF_ENABLED)
+            if(lcdBusyFlagMode){                        //Turn the bus round for status reads
+                LCD_CLR_RS();
+                LCD_DB_IN();
+                LCD_SET_RW();
+                lcdBusyPolls = 0;
+                lcdEngState = LCD_ENG_BF_HI_E_ON;
+                lcdEngRestart(LCD_PIT_E_LDVAL);
+                break;
+            }else{}
+#endif
+            lcdEngState = LCD_ENG_HI_E_ON;
+            if(LCD_LONG_CMD(data)){
+                lcdEngRestart(LCD_PIT_CLR_LDVAL);
+            }else{
+                lcdEngRestart(LCD_PIT_CMD_LDVAL);
+            }
+            break;
+    }
+}
+
+/******************************************************************************
+  lcdEngRestart() - Starts PIT1 counting down a new period       (Private)
+
+        A new LDVAL only takes effect at the next reload, so the timer is
+        stopped and started to load it now.
+******************************************************************************/
+static void lcdEngRestart(INT32U ldval) {
+    PIT_LDVAL1 = ldval;
+    PIT_TCTRL1 = 0;
+    PIT_TCTRL1 = PIT_TCTRL_TIE_MASK | PIT_TCTRL_TEN_MASK;
+}
+
+#if (APP_CFG_LCD_BUSY_FLAG_EN == DEF_ENABLED)
+/******************************************************************************
+  lcdReadWait() - Reads the busy flag and address counter         (Private)
+                  with busy waits. Only used by LcdInit().
+
+  RETURNS: BF in bit 7, address counter in bits 0-6. 0xFF if nothing drives
+           the bus, the pull ups win.
+******************************************************************************/
+static INT8U lcdReadWait(void) {
+    INT8U c;
+
+    LCD_CLR_RS();
+    LCD_DB_IN();
+    LCD_SET_RW();
+    lcdDly500ns();
+    LCD_SET_E();
+    lcdDly500ns();
+    c = (INT8U)(LCD_RD_DB() << 4);
+    LCD_CLR_E();
+    lcdDly500ns();
+    lcdDly500ns();
+    LCD_SET_E();
+    lcdDly500ns();
+    c |= LCD_RD_DB();
+    LCD_CLR_E();
+    LCD_CLR_RW();
+    LCD_DB_OUT();
+    lcdDly500ns();
+    return(c);
+}
+#endif
+
+/******************************************************************************
+  lcdWriteWait() - Writes a command (both data and control busses) (Private)
+                   to the LCD and busy waits for it to execute. Only used
+                   by LcdInit() before the write engine is running.
+******************************************************************************/
+static void lcdWriteWait(INT16U data) {
+    INT8U c;
+#if (APP_CFG_LCD_EMU_EN == DEF_ENABLED)
+    LcdEmuFeed(data);
+#endif
+    // Set/Reset RS
+    if((data & 0x0100) == 0x0100){
+        LCD_SET_RS(); //data write
+    }else{
+        LCD_CLR_RS(); //command write
+    }
+    
+    c = (INT8U)data;
+    // Write character/command to LCD
+    LCD_WR_DB((c>>4));
+    LCD_SET_E();
+    lcdDly500ns();
+    LCD_CLR_E();
+    lcdDly500ns();
+    lcdDly500ns();
+    LCD_WR_DB((c&0x0f));
+    LCD_SET_E();
+    lcdDly500ns();
+    LCD_CLR_E();
+    lcdDlyus(41);
+}
+
+
+/*************************************************************************
+  lcdClear() - Clears a buffer or layer                          (Private)
+*************************************************************************/
+static void lcdClear(LCD_BUFFER *buffer) {
+    INT8U row, col;
+    
+    // For each row...
+    for(row = 0; row < LCD_NUM_ROWS; row++) {
+        // For each column...
+        for(col = 0; col < LCD_NUM_COLS; col++) {
+
+            // Clear the character at that position
+            buffer->lcd_char[row][col] = LCD_CLEAR_BYTE;
+
+        }
+    }
+    
+}
+
+/********************************************************************
+** lcdMoveCursor(INT8U row, INT8U col)
+*
+*  FILENAME: LCD.c
+*
+*  PARAMETERS: row - Destination row (1 or 2).
+*              col - Destination column (1 - 16).
+*
+*  DESCRIPTION: Moves the cursor to [row,col].
+*
+*  RETURNS: None
+********************************************************************/
+static void lcdMoveCursor(INT8U row, INT8U col) {
+   lcdWrite(LCD_DD_RAM((lcdRowAddress[(row-1)]) + (col-1)));
+}
+
+/********************************************************************
+** LcdCursorDispMode(INT8U on, INT8U blink)
+*
+*  FILENAME: LCD.c
+*
+*  PARAMETERS: on - (Binary)Turn cursor on if TRUE, off if FALSE.
+*              blink - (Binary)Cursor blinks if TRUE.
+*
+*  DESCRIPTION: Changes LCD cursor state.
+*
+*  RETURNS: None
+********************************************************************/
+void LcdCursorDispMode(INT8U on, INT8U blink) {
+    lcdWrite(LCD_ON_OFF(1, on, blink));
+}
+
+/********************************************************************
+** LcdHideLayer(INT8U layer)
+*
+*  FILENAME: LcdLayered.c
+*
+*  PARAMETERS: layer - The layer to be hidden
+*
+*  DESCRIPTION: Hides the specified layer and posts the LCD task
+*
+*  RETURNS: None
+********************************************************************/
+void LcdHideLayer(INT8U layer){
+    lcdLayerHidden[layer] = 1;
+    // Redraw now rather than on the next layer write
+    lcdRedraw(LCD_ALL_CELLS);                //Uncovers/covers every cell
+}
+
+
+/********************************************************************
+** LcdShowLayer(INT8U layer)
+*
+*  FILENAME: LcdLayered.c
+*
+*  PARAMETERS: layer - The layer to be shown
+*
+*  DESCRIPTION: Shows the specified layer and posts the LCD task
+*
+*  RETURNS: None
+********************************************************************/
+void LcdShowLayer(INT8U layer){
+    lcdLayerHidden[layer] = 0;
+    // Redraw now rather than on the next layer write
+    lcdRedraw(LCD_ALL_CELLS);                //Uncovers/covers every cell
+}
+
+/********************************************************************
+** LcdToggleLayer(INT8U layer)
+*
+*  FILENAME: LcdLayered.c
+*
+*  PARAMETERS: layer - The layer to be toggled
+*
+*  DESCRIPTION: Toggles the specified layer and posts the LCD task
+*
+*  RETURNS: None
+********************************************************************/
+void LcdToggleLayer(INT8U layer){
+    CPU_SR_ALLOC();
+
+    CPU_CRITICAL_ENTER();                    //Any task may toggle
+    if(lcdLayerHidden[layer]){
+        lcdLayerHidden[layer] = 0;
+    }else{
+        lcdLayerHidden[layer] = 1;
+    }
+    CPU_CRITICAL_EXIT();
+
+    // Redraw now rather than on the next layer write
+    lcdRedraw(LCD_ALL_CELLS);                //Uncovers/covers every cell
+}
+
+#if (APP_CFG_LCD_BENCH_EN == DEF_ENABLED)
+/********************************************************************
+** LcdFlattenBench(void)
+*
+*  FILENAME: LcdLayered.c
+*
+*  PARAMETERS: None
+*
+*  DESCRIPTION: Times lcdFlattenLayers() with 0 to LCD_NUM_CELLS cells
+*               marked dirty so LcdFlattenCycles() has a full sweep. The
+*               layers are not changed, only re-flattened. Call right
+*               after LcdInit(), before the LCD task first runs, since
+*               the flatten is not reentrant.
+*
+*  RETURNS: None
+********************************************************************/
+void LcdFlattenBench(void){
+    INT8U cells;
+    CPU_SR_ALLOC();
+
+    for(cells = 0; cells <= LCD_NUM_CELLS; cells++){
+        CPU_CRITICAL_ENTER();
+        if(cells < LCD_NUM_CELLS){
+            lcdRedrawCells = ((INT32U)1 << cells) - 1;
+        }else{
+            lcdRedrawCells = LCD_ALL_CELLS;
+        }
+        CPU_CRITICAL_EXIT();
+        lcdFlattenLayers(&lcdBuffer);
+    }
+}
+
+/********************************************************************
+** LcdFlattenCycles(INT8U cells)
+*
+*  FILENAME: LcdLayered.c
+*
+*  PARAMETERS: cells - Number of changed cells, 0 to LCD_NUM_CELLS
+*
+*  DESCRIPTION: Worst case core cycles lcdFlattenLayers() took with
+*               that many cells to recompute.
+*
+*  RETURNS: Cycles, 0 if never seen
+********************************************************************/
+INT32U LcdFlattenCycles(INT8U cells){
+    INT32U cycles = 0;
+    if(cells <= LCD_NUM_CELLS){
+        cycles = lcdFlattenCycles[cells];
+    }else{}
+    return cycles;
+}
+#endif
+
+/*************************************************************************
+  lcdDlyus() - Blocks for the passed number of microseconds      (Private)
+*************************************************************************/
+static void lcdDlyus(INT16U us) {
+    INT16U cnt;
+    
+    for(cnt = 0; cnt <= us; cnt++) {
+        lcdDly500ns();
+        lcdDly500ns();
+    }
+
+}
+
+
+/********************************************************************
+** lcdDly500ns(void)
+*   Delays, at least, 500ns
+*   Designed for 120MHz or 150MHz clock.
+ *  Tdly >= (66.5ns)i (at 150MHz)
+ * Currently set to ~532ns with i=8.
+ * TDM 01/20/2013
+********************************************************************/
+static void lcdDly500ns(void){
+    INT32U i;
+    for(i=0;i<8;i++){
+    }
+}
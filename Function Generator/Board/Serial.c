@@ -0,0 +1,117 @@
+/*****************************************************************************************
+* Serial.c - UART2 driver with DMA receive into a ring and DMA send
+*
+* The UART raises a DMA request instead of an interrupt for each byte received (RDMAS)
+* and each free transmit buffer (TDMAS). DMA1 takes received bytes one per minor loop,
+* never stops (DREQ clear) and wraps its destination on the aligned ring with DMOD, so
+* its DADDR is the ring head. DMA2 sends one buffer per major loop and clears its own
+* request enable when done (DREQ set).
+*
+* The UART idle line flag would tell when a line has ended, but it is cleared by reading
+* the data register, which would take a byte from DMA1. The reader polls the head
+* instead. No interrupts are used.
+****************************************************************************************/
+#include "MCUType.h"
+#include "os.h"
+#include "Serial.h"
+
+#define SERIAL_BUS_CLK (DEFAULT_SYSTEM_CLOCK / 3U)
+#define SERIAL_DIV32 (((2U * SERIAL_BUS_CLK) + (SERIAL_BAUD / 2U)) / SERIAL_BAUD) //32*(SBR+BRFA/32)
+#define SERIAL_RX_CH 1U
+#define SERIAL_TX_CH 2U
+#define SERIAL_UART2_RX_SRC 6U                  //DMAMUX sources
+#define SERIAL_UART2_TX_SRC 7U
+
+static INT8U serialRxRing[SERIAL_RX_SIZE] __attribute__((aligned(SERIAL_RX_SIZE)));
+static INT8C serialTxBuf[SERIAL_TX_SIZE];
+
+/*****************************************************************************************
+* SerialInit - The DMA clocks are already on from DMAInit(), they are turned on again
+*              here so the order does not matter. The UART is set up before its DMA
+*              requests are routed so nothing is requested half configured.
+****************************************************************************************/
+void SerialInit(void){
+    SIM_SCGC4 |= SIM_SCGC4_UART2_MASK;
+    SIM_SCGC5 |= SIM_SCGC5_PORTE_MASK;              /* Enable clock gate for PORTE */
+    SIM_SCGC6 |= SIM_SCGC6_DMAMUX_MASK;
+    SIM_SCGC7 |= SIM_SCGC7_DMA_MASK;
+    PORTE_PCR16 = PORT_PCR_MUX(3);                  /* UART2_TX */
+    PORTE_PCR17 = PORT_PCR_MUX(3);                  /* UART2_RX */
+
+    UART2_C2 = 0;
+    UART2_BDH = UART_BDH_SBR((SERIAL_DIV32 >> 5) >> 8);
+    UART2_BDL = UART_BDL_SBR((SERIAL_DIV32 >> 5) & 0xFFU);
+    UART2_C4 = UART_C4_BRFA(SERIAL_DIV32 & 0x1FU);
+    UART2_C5 = UART_C5_RDMAS_MASK | UART_C5_TDMAS_MASK;
+
+    //Receive, forever into the ring
+    DMAMUX_CHCFG(SERIAL_RX_CH) = 0;
+    DMA_SADDR(SERIAL_RX_CH) = DMA_SADDR_SADDR(&UART2_D);
+    DMA_SOFF(SERIAL_RX_CH) = DMA_SOFF_SOFF(0);
+    DMA_SLAST(SERIAL_RX_CH) = DMA_SLAST_SLAST(0);
+    DMA_DADDR(SERIAL_RX_CH) = DMA_DADDR_DADDR(serialRxRing);
+    DMA_DOFF(SERIAL_RX_CH) = DMA_DOFF_DOFF(1);
+    DMA_DLAST_SGA(SERIAL_RX_CH) = DMA_DLAST_SGA_DLASTSGA(0);
+    DMA_ATTR(SERIAL_RX_CH) = (DMA_ATTR_SSIZE(0) | DMA_ATTR_SMOD(0) | DMA_ATTR_DMOD(SERIAL_RX_MOD) | DMA_ATTR_DSIZE(0));
+    DMA_NBYTES_MLNO(SERIAL_RX_CH) = DMA_NBYTES_MLNO_NBYTES(1);
+    DMA_CITER_ELINKNO(SERIAL_RX_CH) = DMA_CITER_ELINKNO_ELINK(0)|DMA_CITER_ELINKNO_CITER(SERIAL_RX_SIZE);
+    DMA_BITER_ELINKNO(SERIAL_RX_CH) = DMA_BITER_ELINKNO_ELINK(0)|DMA_BITER_ELINKNO_BITER(SERIAL_RX_SIZE);
+    DMA_CSR(SERIAL_RX_CH) = DMA_CSR_DREQ(0);
+    DMAMUX_CHCFG(SERIAL_RX_CH) = DMAMUX_CHCFG_ENBL(1)|DMAMUX_CHCFG_SOURCE(SERIAL_UART2_RX_SRC);
+    DMA_SERQ = DMA_SERQ_SERQ(SERIAL_RX_CH);
+
+    //Send, started by SerialWrite()
+    DMAMUX_CHCFG(SERIAL_TX_CH) = 0;
+    DMA_SADDR(SERIAL_TX_CH) = DMA_SADDR_SADDR(serialTxBuf);
+    DMA_SOFF(SERIAL_TX_CH) = DMA_SOFF_SOFF(1);
+    DMA_SLAST(SERIAL_TX_CH) = DMA_SLAST_SLAST(0);
+    DMA_DADDR(SERIAL_TX_CH) = DMA_DADDR_DADDR(&UART2_D);
+    DMA_DOFF(SERIAL_TX_CH) = DMA_DOFF_DOFF(0);
+    DMA_DLAST_SGA(SERIAL_TX_CH) = DMA_DLAST_SGA_DLASTSGA(0);
+    DMA_ATTR(SERIAL_TX_CH) = (DMA_ATTR_SSIZE(0) | DMA_ATTR_SMOD(0) | DMA_ATTR_DMOD(0) | DMA_ATTR_DSIZE(0));
+    DMA_NBYTES_MLNO(SERIAL_TX_CH) = DMA_NBYTES_MLNO_NBYTES(1);
+    DMA_CSR(SERIAL_TX_CH) = DMA_CSR_DREQ(1);
+    DMAMUX_CHCFG(SERIAL_TX_CH) = DMAMUX_CHCFG_ENBL(1)|DMAMUX_CHCFG_SOURCE(SERIAL_UART2_TX_SRC);
+
+    UART2_C2 = UART_C2_TE_MASK | UART_C2_RE_MASK | UART_C2_TIE_MASK | UART_C2_RIE_MASK;
+}
+
+/*****************************************************************************************
+* SerialRxRing - The receive ring
+****************************************************************************************/
+const INT8U *SerialRxRing(void){
+    return serialRxRing;
+}
+
+/*****************************************************************************************
+* SerialRxHead - DMA1's destination address as a ring index
+****************************************************************************************/
+INT16U SerialRxHead(void){
+    return (INT16U)((DMA_DADDR(SERIAL_RX_CH) - (INT32U)serialRxRing) & SERIAL_RX_MASK);
+}
+
+/*****************************************************************************************
+* SerialWrite - Copies data to the send buffer once DMA2 is done with it, then restarts
+*               DMA2 on it. Longer data is cut to SERIAL_TX_SIZE.
+****************************************************************************************/
+void SerialWrite(const INT8C *data, INT16U len){
+    OS_ERR os_err;
+    INT16U i;
+
+    if(len > SERIAL_TX_SIZE){
+        len = SERIAL_TX_SIZE;
+    }else{}
+    if(len > 0){
+        while((DMA_ERQ & DMA_ERQ_ERQ2_MASK) != 0){  //Last send still going
+            OSTimeDly(1, OS_OPT_TIME_DLY, &os_err);
+        }
+        for(i = 0; i < len; i++){
+            serialTxBuf[i] = data[i];
+        }
+        DMA_CDNE = DMA_CDNE_CDNE(SERIAL_TX_CH);
+        DMA_SADDR(SERIAL_TX_CH) = DMA_SADDR_SADDR(serialTxBuf);
+        DMA_CITER_ELINKNO(SERIAL_TX_CH) = DMA_CITER_ELINKNO_ELINK(0)|DMA_CITER_ELINKNO_CITER(len);
+        DMA_BITER_ELINKNO(SERIAL_TX_CH) = DMA_BITER_ELINKNO_ELINK(0)|DMA_BITER_ELINKNO_BITER(len);
+        DMA_SERQ = DMA_SERQ_SERQ(SERIAL_TX_CH);
+    }else{}
+}
@@ -0,0 +1,41 @@
+/*****************************************************************************************
+* Serial.h - UART2 on the TWR-K65 OpenSDA virtual COM port, 115200 8N1
+*
+* Received bytes are moved by DMA1 into a ring the reader parses in place, the driver
+* never copies them. DMA1 runs for good with modulo addressing on the destination, so
+* the ring must be a power of two in size and aligned to it. The only receive state the
+* driver has is where the DMA writes next; the reader keeps its own tail and must keep
+* within SERIAL_RX_SIZE bytes of the head, an overrun is not detected.
+* Sent bytes are copied to a buffer DMA2 sends from.
+****************************************************************************************/
+#ifndef SERIAL_H_
+#define SERIAL_H_
+
+#define SERIAL_BAUD 115200U
+#define SERIAL_RX_MOD 11U                       //DMA DMOD, ring is 2^SERIAL_RX_MOD bytes
+#define SERIAL_RX_SIZE (1U << SERIAL_RX_MOD)    //~178ms of input at SERIAL_BAUD
+#define SERIAL_RX_MASK (SERIAL_RX_SIZE - 1U)
+#define SERIAL_TX_SIZE 64U                      //Longest string SerialWrite() sends
+
+/*****************************************************************************************
+* SerialInit - Sets up UART2 on PTE16/PTE17 and starts DMA1 receiving into the ring
+****************************************************************************************/
+void SerialInit(void);
+
+/*****************************************************************************************
+* SerialRxRing - The receive ring. Index it with SERIAL_RX_MASK applied.
+****************************************************************************************/
+const INT8U *SerialRxRing(void);
+
+/*****************************************************************************************
+* SerialRxHead - Ring index DMA1 writes the next byte received to
+****************************************************************************************/
+INT16U SerialRxHead(void);
+
+/*****************************************************************************************
+* SerialWrite - Sends len bytes of data, at most SERIAL_TX_SIZE. Delays a tick at a
+*               time while the last send is still going, so call it from one task only.
+****************************************************************************************/
+void SerialWrite(const INT8C *data, INT16U len);
+
+#endif /* SERIAL_H_ */
@@ -1,160 +1,325 @@
-/*
- * TSI.c
- *
- * Touch Sensing Interface
- *
- * Contains all the code reqired to use the K65's Touch Pads using the Cortex M4 TSI hardware
- *
- *
- *  Created on: Dec 4, 2017
- *      Author: mesecar
- *
- * 	Modified to work with Micro C/OS
- * 	~Rod Mesecar, 2/12/18
- *
- * 	Added TouchPend function
- * 	~Rod Mesecar. 2/13/18
- */
-#include "MCUType.h"
-#include "app_cfg.h"
-#include "os.h"
-#include "TSI.h"
-#include "K65TWR_GPIO.h" // Here for debug bit
-
-// Defined Constants
-#define ELEC1 0U
-#define ELEC2 1U
-#define ELEC1_LEVEL_OFFSET 500U // Offset needed for detecting a touch to electrode 1
-#define ELEC2_LEVEL_OFFSET 500U// Offset needed for detecting a touch to electrode 2
-#define SENSOR_TASK_DELAY 10U // Delay for the TSI Task (about every 18ms required for sensing input)
-#define ELECTRODE_BASE_VALUE 12U
-
-// Micro C/OS stuff
-static OS_TCB TSITaskTCB;
-static CPU_STK TSITaskStk[APP_CFG_TSI_TASK_STK_SIZE];
-static OS_SEM TSINewTouchFlag;
-
-// Private Prototypes
-void TSISensorTask(void *p_arg);
-
-// Variables
-static INT16U tsiTouchLevel[2]; // Holds the threshold for what is considered a touch
-static INT8U TsiFlags =0; // Flags indicate which of the sensors are currently active
-                  //1 = Electrode 1; 2 = Electrode 2; 3 = both Electrode 1 & 2
-
-// Touch Sensing Input Initialization code
-// Sets up the system to be able to use TSI.
-void TSIInit(void){
-	INT16U tsibaselevel[2];
-	OS_ERR os_err;
-
-	// Clock
-    SIM_SCGC5 |= SIM_SCGC5_PORTB_MASK |SIM_SCGC5_TSI_MASK;
-
-    //Electrode Bit Muxes
-    PORTB_PCR18 |= PORT_PCR_MUX(0);
-    PORTB_PCR19 |= PORT_PCR_MUX(0);
-
-    //Configure
-    TSI0_GENCS |= TSI_GENCS_REFCHRG(5)|TSI_GENCS_DVOLT(1)|TSI_GENCS_PS(5)|TSI_GENCS_NSCN(15)|TSI_GENCS_EXTCHRG(5);
-
-    //Enable
-    TSI0_GENCS |= TSI_GENCS_TSIEN_MASK;
-
-    //Perform Calculations
-    //ELEC1
-    TSI0_DATA= TSI_DATA_TSICH(12);                                              // Designate Electrode 1 for scan
-    TSI0_DATA |= TSI_DATA_SWTS(1);                                              // Scan
-    while(!(TSI0_GENCS & TSI_GENCS_EOSF_MASK)){}                                // Blocking code - Wait for scan to complete
-    TSI0_GENCS |= TSI_GENCS_EOSF(1);                                            //Clear the flag
-    tsibaselevel[ELEC1] = (INT16U)(TSI0_DATA & TSI_DATA_TSICNT_MASK);           // Set Base level for Electrode 1
-    tsiTouchLevel[ELEC1] = tsibaselevel[ELEC1] + (INT16U)ELEC1_LEVEL_OFFSET;    // Set trigger level for Electrode 1
-
-    //ELEC2
-    TSI0_DATA= TSI_DATA_TSICH(11);                                              // Designate Electrode 2
-    TSI0_DATA |= TSI_DATA_SWTS(1);                                              // Scan
-    while(!(TSI0_GENCS & TSI_GENCS_EOSF_MASK)){}                                // Blocking code - Wait for scan to complete
-    TSI0_GENCS |= TSI_GENCS_EOSF(1);                                            // Clear flag
-    tsibaselevel[ELEC2] = (INT16U)(TSI0_DATA & TSI_DATA_TSICNT_MASK);           // Set base level for Electrode 2
-    tsiTouchLevel[ELEC2] = tsibaselevel[ELEC2] + (INT16U)ELEC2_LEVEL_OFFSET;    // Set base level for Electrode 2
-
-    OSSemCreate(&TSINewTouchFlag, "New Touch Flag", 0,&os_err);
-    while(os_err != OS_ERR_NONE){}              //Error Trap
-
-    // Create Micro C/OS task
-    OSTaskCreate(&TSITaskTCB,
-                     "TSI Sensor Task",
-					 TSISensorTask,
-                     (void *) 0,
-					 APP_CFG_TSI_TASK_PRIO,
-                     &TSITaskStk[0],
-                     (APP_CFG_TSI_TASK_STK_SIZE / 10u),
-                     APP_CFG_TSI_TASK_STK_SIZE,
-                     0,
-                     0,
-                     (void *) 0,
-                     (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR),
-                     &os_err);
-    while(os_err != OS_ERR_NONE){}              //Error Trap
-}
-
-
-// Handles all the Scanning and value setting.
-void TSISensorTask(void *p_arg){
-    (void)p_arg;
-    OS_ERR os_err;
-    static INT8U which_electrode = ELEC1; // Initialize with Electrode 1 First
-    static INT8U last_touch = 0;
-    static INT8U second_to_last_touch = 0;
-    while(1){
-        //Wait
-        DB2_TURN_OFF();
-        OSTimeDly(SENSOR_TASK_DELAY,OS_OPT_TIME_PERIODIC,&os_err);
-        DB2_TURN_ON();
-
-        if ((TSI0_GENCS & TSI_GENCS_SCNIP_MASK) == 0){ // No Scan Active
-            // Check for touch
-            if ((INT16U)(TSI0_DATA & TSI_DATA_TSICNT_MASK)>tsiTouchLevel[which_electrode]){ //Touch Detected
-                if(which_electrode == ELEC1){
-                    TsiFlags = 1;
-                }else {
-                    TsiFlags = 2;
-                }
-            }else{// No touch
-                TsiFlags =0;
-            }
-
-            // Check for 'deboucne' (must remove finger from sensor)
-            if((last_touch != TsiFlags) && (TsiFlags != 0)&& (second_to_last_touch != TsiFlags)){
-            	OSSemPost(&TSINewTouchFlag, OS_OPT_POST_1, &os_err);
-            }else{
-            	// Do nothing.
-            }
-            second_to_last_touch =last_touch;
-            last_touch = TsiFlags;
-
-            // Change the Electrode to Scan.
-            if (which_electrode == ELEC1){
-                which_electrode = ELEC2;
-            }else if (which_electrode == ELEC2){
-                which_electrode = ELEC1;
-            }else{ // ERROR, SHOULD NEVER BE THE CASE
-            // Default to Electrode 1
-                which_electrode = ELEC1;
-            }
-            // Start next scan
-            TSI0_DATA= TSI_DATA_TSICH((ELECTRODE_BASE_VALUE - which_electrode)); // if which_electrode is ELECT1, 12-0 = 12: if which_electrode is ELECT2, 12-1 = 11
-            TSI0_DATA |= TSI_DATA_SWTS(1);
-        }else{ // Scan is in Progress
-        // Do Nothing
-        }
-    }
-}
-
-// When called, pends on the TSItouchBufferKey and returns a copy of the TsiFlags
-//1 = Electrode 1; 2 = Electrode 2;
-//Design Inspired by Prof. Morten's KeyPend code in uCOSKEY module
-INT8U TouchPend(OS_ERR *os_err){
-    OSSemPend(&TSINewTouchFlag, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, os_err);
-    return TsiFlags;
-}
+/*
+ * TSI.c
+ *
+ * Touch Sensing Interface
+ *
+ * Contains all the code reqired to use the K65's Touch Pads using the Cortex M4 TSI hardware
+ *
+ *
+ *  Created on: Dec 4, 2017
+ *      Author: mesecar
+ *
+ * 	Modified to work with Micro C/OS
+ * 	~Rod Mesecar, 2/12/18
+ *
+ * 	Added TouchPend function
+ * 	~Rod Mesecar. 2/13/18
+ *
+ * 	Scans are now started by the LPTMR0 hardware trigger every
+ * 	TSI_SCAN_PERIOD_MS, alternating electrodes. TSI0_TSHD holds the
+ * 	touch level of the electrode being scanned, so the TSI sets OUTRGF
+ * 	on a touch and the end of scan interrupt only reads the flag and
+ * 	switches electrode. The kernel is only entered when a touch is
+ * 	posted, there is no sensor task.
+ *
+ * 	The baselines are measured by the same interrupt after start up:
+ * 	blocks of TSI_CAL_SCANS scans of each electrode are averaged until
+ * 	two blocks in a row agree within TSI_CAL_TOL. Until then the
+ * 	threshold is out of reach and no touches are reported, and
+ * 	TSIInit() no longer waits on any scan.
+ *
+ * 	After calibration each electrode's baseline and noise follow the
+ * 	untouched counts through fixed point IIR filters, see tsiTrack().
+ * 	The touch level is the baseline plus the larger of the electrode's
+ * 	offset and TSI_NOISE_K times the noise, and a touch is released
+ * 	at half that delta, so drift neither fakes nor hides touches.
+ */
+#include "MCUType.h"
+#include "app_cfg.h"
+#include "os.h"
+#include "TSI.h"
+#include "K65TWR_GPIO.h" // Here for debug bit
+
+// Defined Constants
+#define ELEC1 0U
+#define ELEC2 1U
+#define ELEC1_LEVEL_OFFSET 500U // Offset needed for detecting a touch to electrode 1
+#define ELEC2_LEVEL_OFFSET 500U// Offset needed for detecting a touch to electrode 2
+#define TSI_SCAN_PERIOD_MS 20U // Longer than a scan (~18ms), one electrode per scan
+#define TSI_IRQ_PRIO 12U // Below the DMA, LCD and keypad interrupts
+#define ELECTRODE_BASE_VALUE 12U
+#define TSI_CHANNEL(elec) TSI_DATA_TSICH((ELECTRODE_BASE_VALUE - (elec))) // ELEC1 -> 12, ELEC2 -> 11
+#define TSI_GENCS_FLAGS (TSI_GENCS_EOSF_MASK | TSI_GENCS_OUTRGF_MASK) // Write 1 to clear
+#define TSI_CAL_SCANS 8U // Scans per electrode averaged for a baseline, power of 2
+#define TSI_CAL_TOL 50U // Counts two baselines may differ by to be converged
+#define TSI_NO_THRESH 0xFFFFU // THRESH no count can exceed, during calibration
+#define TSI_FRAC_BITS 8U // Fraction bits of the baseline and noise filters
+#define TSI_BASE_SHIFT 8U // Baseline rises over ~256 scans (~10s)
+#define TSI_BASE_DOWN_SHIFT 4U // and falls over ~16, a touch never lowers the count
+#define TSI_NOISE_SHIFT 5U // Noise averages ~32 scans
+#define TSI_NOISE_K 8U // Touch delta is at least this many times the noise
+#define TSI_STUCK_SCANS 750U // Touched for ~30s, the baseline jumped, take the count
+
+typedef struct{
+    INT32U base; // Untouched count, TSI_FRAC_BITS fraction bits
+    INT32U noise; // Mean absolute deviation from base, TSI_FRAC_BITS fraction bits
+    INT16U offset; // Smallest touch delta, ELECx_LEVEL_OFFSET
+    INT16U on_level; // TSHD while untouched
+    INT16U off_level; // TSHD while touched
+    INT16U touch_scans; // Scans since the touch started
+    INT8U touched;
+} TSI_ELEC;
+
+// Micro C/OS stuff
+static OS_SEM TSINewTouchFlag;
+
+// Variables
+static TSI_ELEC tsiElec[2] = {{0, 0, ELEC1_LEVEL_OFFSET, TSI_NO_THRESH, TSI_NO_THRESH, 0, FALSE},
+                               {0, 0, ELEC2_LEVEL_OFFSET, TSI_NO_THRESH, TSI_NO_THRESH, 0, FALSE}};
+static INT8U TsiFlags =0; // Flags indicate which of the sensors are currently active
+                  //1 = Electrode 1; 2 = Electrode 2; 3 = both Electrode 1 & 2
+static INT8U tsiTouch = 0; // TsiFlags when the last touch was posted
+static INT8U tsiWhichElectrode = ELEC1; // Electrode of the scan in progress
+static INT8U tsiLastTouch = 0;
+static INT8U tsiSecondToLastTouch = 0;
+static OS_FLAG_GRP *tsiNotifyGrp = (OS_FLAG_GRP *)0;
+static OS_FLAGS tsiNotifyFlag;
+static INT8U tsiCalibrated = FALSE; // TRUE once the baselines converged
+static INT32U tsiCalSum[2];
+static INT8U tsiCalCnt[2];
+static INT16U tsiCalBase[2]; // Average of the last block, 0 before the first
+
+// Private Prototypes
+static void tsiCalScan(INT8U electrode, INT16U count);
+static INT8U tsiTrack(TSI_ELEC *elec, INT16U count, INT8U above);
+static void tsiLevels(TSI_ELEC *elec);
+
+// Touch Sensing Input Initialization code
+// Sets up the system to be able to use TSI.
+void TSIInit(void){
+	OS_ERR os_err;
+
+	// Clock
+    SIM_SCGC5 |= SIM_SCGC5_PORTB_MASK |SIM_SCGC5_TSI_MASK;
+
+    //Electrode Bit Muxes
+    PORTB_PCR18 |= PORT_PCR_MUX(0);
+    PORTB_PCR19 |= PORT_PCR_MUX(0);
+
+    //Configure
+    TSI0_GENCS |= TSI_GENCS_REFCHRG(5)|TSI_GENCS_DVOLT(1)|TSI_GENCS_PS(5)|TSI_GENCS_NSCN(15)|TSI_GENCS_EXTCHRG(5);
+
+    //Enable
+    TSI0_GENCS |= TSI_GENCS_TSIEN_MASK;
+
+    OSSemCreate(&TSINewTouchFlag, "New Touch Flag", 0,&os_err);
+    while(os_err != OS_ERR_NONE){}              //Error Trap
+
+    // Hardware triggered scanning, calibrating until the baselines converge
+    TSI0_TSHD = TSI_TSHD_THRESH(TSI_NO_THRESH) | TSI_TSHD_THRESL(0);
+    TSI0_DATA = TSI_CHANNEL(ELEC1);
+    TSI0_GENCS |= TSI_GENCS_STM_MASK | TSI_GENCS_ESOR_MASK | TSI_GENCS_TSIIEN_MASK | TSI_GENCS_FLAGS;
+    NVIC_SetPriority(TSI0_IRQn, TSI_IRQ_PRIO);
+    NVIC_ClearPendingIRQ(TSI0_IRQn);
+    NVIC_EnableIRQ(TSI0_IRQn);
+
+    // LPTMR0 from the 1kHz LPO, its compare is the TSI hardware trigger
+    SIM_SCGC5 |= SIM_SCGC5_LPTMR_MASK;
+    LPTMR0_CSR = 0;
+    LPTMR0_PSR = LPTMR_PSR_PCS(1) | LPTMR_PSR_PBYP_MASK;
+    LPTMR0_CMR = TSI_SCAN_PERIOD_MS - 1U;
+    LPTMR0_CSR = LPTMR_CSR_TEN_MASK;
+}
+
+
+// End of scan interrupt. The TSI compared the count with TSI0_TSHD, the
+// on level of an untouched electrode or the off level of a touched one,
+// so OUTRGF gives the touch with hysteresis and tsiTrack() only has to
+// update the filters. While calibrating the count goes to tsiCalScan()
+// instead. Switches to the
+// other electrode for the next hardware triggered scan. Enters the
+// kernel only when a new touch is posted.
+// Debounce as before, the finger must be removed from the sensor.
+void TSI0_IRQHandler(void){
+    OS_ERR os_err;
+    INT32U gencs = TSI0_GENCS;
+
+    INT16U count = (INT16U)(TSI0_DATA & TSI_DATA_TSICNT_MASK);
+    TSI_ELEC *next;
+
+    TSI0_GENCS = gencs; // Clears EOSF and OUTRGF
+    if (tsiCalibrated == FALSE){
+        tsiCalScan(tsiWhichElectrode, count);
+        TsiFlags = 0;
+    }else if (tsiTrack(&tsiElec[tsiWhichElectrode], count, (gencs & TSI_GENCS_OUTRGF_MASK) != 0)){ //Touch Detected
+        if(tsiWhichElectrode == ELEC1){
+            TsiFlags = 1;
+        }else {
+            TsiFlags = 2;
+        }
+    }else{// No touch
+        TsiFlags =0;
+    }
+
+    // Change the Electrode to Scan.
+    if (tsiWhichElectrode == ELEC1){
+        tsiWhichElectrode = ELEC2;
+    }else{
+        tsiWhichElectrode = ELEC1;
+    }
+    next = &tsiElec[tsiWhichElectrode];
+    if (next->touched){
+        TSI0_TSHD = TSI_TSHD_THRESH(next->off_level) | TSI_TSHD_THRESL(0);
+    }else{
+        TSI0_TSHD = TSI_TSHD_THRESH(next->on_level) | TSI_TSHD_THRESL(0); // TSI_NO_THRESH while calibrating
+    }
+    TSI0_DATA = TSI_CHANNEL(tsiWhichElectrode);
+
+    // Check for 'deboucne' (must remove finger from sensor)
+    if((tsiLastTouch != TsiFlags) && (TsiFlags != 0)&& (tsiSecondToLastTouch != TsiFlags)){
+        OSIntEnter();
+        tsiTouch = TsiFlags;
+        (void)OSSemPost(&TSINewTouchFlag, OS_OPT_POST_1, &os_err);
+        if (tsiNotifyGrp != (OS_FLAG_GRP *)0){
+            (void)OSFlagPost(tsiNotifyGrp, tsiNotifyFlag, OS_OPT_POST_FLAG_SET, &os_err);
+        }else{}
+        OSIntExit();
+    }else{
+        // Do nothing.
+    }
+    tsiSecondToLastTouch = tsiLastTouch;
+    tsiLastTouch = TsiFlags;
+}
+
+// Adds a calibration scan. Once both electrodes have a full block the
+// averages are compared with the previous block's. If both are within
+// TSI_CAL_TOL they become the baselines and touch sensing starts,
+// otherwise (first block, or a finger on a pad) another block is taken.
+static void tsiCalScan(INT8U electrode, INT16U count){
+    INT8U elec;
+    INT16U avg;
+    INT8U converged = TRUE;
+
+    if (tsiCalCnt[electrode] < TSI_CAL_SCANS){
+        tsiCalSum[electrode] += count;
+        tsiCalCnt[electrode]++;
+    }else{ // Waiting for the other electrode
+    }
+    if ((tsiCalCnt[ELEC1] == TSI_CAL_SCANS) && (tsiCalCnt[ELEC2] == TSI_CAL_SCANS)){
+        for (elec = ELEC1; elec <= ELEC2; elec++){
+            avg = (INT16U)(tsiCalSum[elec] / TSI_CAL_SCANS);
+            if ((avg > (tsiCalBase[elec] + TSI_CAL_TOL)) || ((avg + TSI_CAL_TOL) < tsiCalBase[elec])){
+                converged = FALSE;
+            }else{}
+            tsiCalBase[elec] = avg;
+            tsiCalSum[elec] = 0;
+            tsiCalCnt[elec] = 0;
+        }
+        if (converged){
+            for (elec = ELEC1; elec <= ELEC2; elec++){
+                tsiElec[elec].base = (INT32U)tsiCalBase[elec] << TSI_FRAC_BITS;
+                tsiElec[elec].noise = 0;
+                tsiLevels(&tsiElec[elec]);
+            }
+            tsiCalibrated = TRUE;
+        }else{}
+    }else{}
+}
+
+// Updates an electrode from one scan. above is OUTRGF, the count was over
+// the level loaded for it. While untouched the baseline follows the count,
+// slowly up so a slow approach can't raise it much and quickly down, and
+// the noise follows the deviation. Both are held during a touch. A touch
+// lasting TSI_STUCK_SCANS is taken as a baseline step (a change that
+// made the pad look touched) and the count becomes the baseline.
+// Returns TRUE if the electrode is touched.
+static INT8U tsiTrack(TSI_ELEC *elec, INT16U count, INT8U above){
+    INT32U sample = (INT32U)count << TSI_FRAC_BITS;
+    INT32U dev;
+
+    if (elec->touched){
+        if (above == FALSE){ // Fell below the off level
+            elec->touched = FALSE;
+        }else if (++elec->touch_scans >= TSI_STUCK_SCANS){
+            elec->base = sample;
+            elec->touched = FALSE;
+        }else{}
+    }else if (above){ // Rose over the on level
+        elec->touched = TRUE;
+        elec->touch_scans = 0;
+    }else{
+        if (sample >= elec->base){
+            dev = sample - elec->base;
+            elec->base += dev >> TSI_BASE_SHIFT;
+        }else{
+            dev = elec->base - sample;
+            elec->base -= dev >> TSI_BASE_DOWN_SHIFT;
+        }
+        elec->noise += (dev >> TSI_NOISE_SHIFT);
+        elec->noise -= (elec->noise >> TSI_NOISE_SHIFT);
+    }
+    tsiLevels(elec);
+    return elec->touched;
+}
+
+// Sets the on and off levels from the baseline and noise
+static void tsiLevels(TSI_ELEC *elec){
+    INT32U base = elec->base >> TSI_FRAC_BITS;
+    INT32U delta = (elec->noise * TSI_NOISE_K) >> TSI_FRAC_BITS;
+
+    if (delta < elec->offset){
+        delta = elec->offset;
+    }else if (delta > (TSI_NO_THRESH / 2U)){
+        delta = TSI_NO_THRESH / 2U;
+    }else{}
+    if ((base + delta) >= TSI_NO_THRESH){
+        base = TSI_NO_THRESH - 1U - delta;
+    }else{}
+    elec->on_level = (INT16U)(base + delta);
+    elec->off_level = (INT16U)(base + (delta / 2U));
+}
+
+// TRUE once the start up calibration is done and touches are reported
+INT8U TSICalibrated(void){
+    return tsiCalibrated;
+}
+
+// When called, pends on the TSItouchBufferKey and returns a copy of the TsiFlags
+//1 = Electrode 1; 2 = Electrode 2;
+//Design Inspired by Prof. Morten's KeyPend code in uCOSKEY module
+INT8U TouchPend(OS_ERR *os_err){
+    OSSemPend(&TSINewTouchFlag, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, os_err);
+    return tsiTouch;
+}
+
+// Debounced state of both electrodes, updated every other scan
+INT8U TouchHeld(void){
+    INT8U held = 0;
+
+    if (tsiElec[ELEC1].touched){
+        held |= 1;
+    }else{}
+    if (tsiElec[ELEC2].touched){
+        held |= 2;
+    }else{}
+    return held;
+}
+
+// Same as TouchPend() without waiting, returns 0 if no touch was posted
+INT8U TouchAccept(void){
+    OS_ERR os_err;
+    INT8U touch = 0;
+
+    OSSemPend(&TSINewTouchFlag, 0, OS_OPT_PEND_NON_BLOCKING, (CPU_TS *)0, &os_err);
+    if (os_err == OS_ERR_NONE){
+        touch = tsiTouch;
+    }else{ // No touch waiting
+    }
+    return touch;
+}
+
+// Set before the scan interrupt is enabled, so it never sees half of it
+void TouchNotify(OS_FLAG_GRP *grp, OS_FLAGS flag){
+    tsiNotifyFlag = flag;
+    tsiNotifyGrp = grp;
+}
@@ -1,22 +1,40 @@
-/*
- * TSI.h
- * Touch Sensing Input
- *
- * Contains all the code reqired to use the K65's Touch Pads using the Cortex M4 TSI hardware
- *
- *  Created on: Dec 4, 2017
- *      Author: mesecar
- *
- */
-
-#ifndef BOARD_TSI_H_
-#define BOARD_TSI_H_
-
-// Initializes the touch Sensor Module
-void TSIInit(void);
-
-// When called, pends on the TSItouchBufferKey and returns a copy of the TsiFlags and clears TsiFlags.
-// 0 = None; 1 = Electrode 1; 2 = Electrode 2; 3 = both Electrode 1 & 2
-INT8U TouchPend(OS_ERR *os_err);
-
-#endif /* BOARD_TSI_H_ */
+/*
+ * TSI.h
+ * Touch Sensing Input
+ *
+ * Contains all the code reqired to use the K65's Touch Pads using the Cortex M4 TSI hardware
+ *
+ *  Created on: Dec 4, 2017
+ *      Author: mesecar
+ *
+ */
+
+#ifndef BOARD_TSI_H_
+#define BOARD_TSI_H_
+
+// Initializes the touch Sensor Module
+void TSIInit(void);
+
+// When called, pends on the TSItouchBufferKey and returns a copy of the TsiFlags and clears TsiFlags.
+// 0 = None; 1 = Electrode 1; 2 = Electrode 2; 3 = both Electrode 1 & 2
+INT8U TouchPend(OS_ERR *os_err);
+
+// Takes a touch posted for TouchPend() without waiting, 0 if none
+INT8U TouchAccept(void);
+
+// Electrodes touched as of the last scan of each, same codes as
+// TouchPend(). For telling how long a posted touch is held.
+INT8U TouchHeld(void);
+
+// Also sets flag in grp with each touch posted, so a task can wait on
+// touches and other inputs together. Call once, before TSIInit().
+void TouchNotify(OS_FLAG_GRP *grp, OS_FLAGS flag);
+
+// TRUE once the baselines measured after TSIInit() have converged,
+// no touches are reported before that
+INT8U TSICalibrated(void);
+
+// End of scan interrupt, posts a new touch for TouchPend()
+void TSI0_IRQHandler(void);
+
+#endif /* BOARD_TSI_H_ */
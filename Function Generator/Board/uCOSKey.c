@@ -1,223 +1,420 @@
-/********************************************************************
-* uCOSKey.c - A keypad module that runs under MicroC/OS for a 4x4 
-* matrix keypad.
-* This version allows for multiple column keys to be pressed and 
-* mapped to a different code by changing ColTable[] in keyScan().
-* Multiple rows can not be resolved. The topmost button will be used.
-* The keyCodeTable[] is currently set to generate ASCII codes.
-*
-* Requires the following be defined in app_cfg.h:
-*                   APP_CFG_KEY_TASK_PRIO
-*                   APP_CFG_KEY_TASK_STK_SIZE
-*
-* 02/20/2001 TDM Original key.c for 9S12
-* 01/14/2013 TDM Modified for K70 custom tower board.
-* 02/12/2013 TDM Modified to run under MicroC/OS-III
-* 01/18/2018 Changed to replace includes.h TDM
-* 02/01/2018 Brian Willis changed KeyTask() DB Bit from 4 to 1
-*********************************************************************
-* Header Files - Dependencies
-********************************************************************/
-#include "MCUType.h"
-#include "app_cfg.h"
-#include "os.h"
-#include "uCOSKey.h"
-#include "k65TWR_GPIO.h"
-/********************************************************************
-* Module Defines
-* This version is designed for the custom LCD/Keypad board, which
-* has the following mapping:
-*  COL1->PTC3, COL2->PTC4, COL3->PTC5, COL4->PTC6
-*  ROW1->PTC7, ROW2->PTC8, ROW3->PTC9, ROW4->PTC10
-********************************************************************/
-typedef enum{KEY_OFF,KEY_EDGE,KEY_VERF} KEYSTATES;
-#define KEY_PORT_OUT   GPIOC_PDOR
-#define KEY_PORT_DIR   GPIOC_PDDR
-#define KEY_PORT_IN	   GPIOC_PDIR
-#define COLS_MASK 0x00000078
-#define ROWS_MASK 0x00000780
-#define DC1 (INT8U)0x11     /*ASCII control code for the A button */
-#define DC2 (INT8U)0x12     /*ASCII control code for the B button */
-#define DC3 (INT8U)0x13     /*ASCII control code for the C button */
-#define DC4 (INT8U)0x14     /*ASCII control code for the D button */
-typedef struct{
-    INT8U buffer;
-    OS_SEM flag;
-}KEY_BUFFER;
-/********************************************************************
-* Private Resources
-********************************************************************/
-static INT8U keyScan(void);         /* Makes a single keypad scan  */
-static const INT8U keyCodeTable[16] =
-   {'1','2','3',DC1,'4','5','6',DC2,'7','8','9',DC3,'*','0','#',DC4};
-static void keyDly(void);  /* Added for GPIO to settle before read */
-static void keyTask(void *p_arg);
-static KEY_BUFFER keyBuffer;
-/**********************************************************************************
-* Allocate task control blocks
-**********************************************************************************/
-static OS_TCB keyTaskTCB;
-/*************************************************************************
-* Allocate task stack space.
-*************************************************************************/
-static CPU_STK keyTaskStk[APP_CFG_KEY_TASK_STK_SIZE];
-
-/********************************************************************
-* KeyPend() - A function to provide access to the key buffer via a
-*             semaphore.
-*    - Public
-********************************************************************/
-INT8U KeyPend(INT16U tout, OS_ERR *os_err){
-    OSSemPend(&(keyBuffer.flag),tout, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, os_err);
-    return(keyBuffer.buffer);
-}
-
-/********************************************************************
-* KeyInit() - Initialization routine for the keypad module
-*             The columns are normally set as inputs and, since they 
-*             are pulled high, they are one. Then to pull a row low
-*             during scanning, the direction for that pin is changed
-*             to an output.
-********************************************************************/
-void KeyInit(void){
-
-    OS_ERR os_err;
-	/* Key port init */
-    SIM_SCGC5 |= SIM_SCGC5_PORTC_MASK;              /* Enable clock gate for PORTC */
-    PORTC_PCR3=PORT_PCR_MUX(1)|PORT_PCR_PS_MASK|PORT_PCR_PE_MASK;
-    PORTC_PCR4=PORT_PCR_MUX(1)|PORT_PCR_PS_MASK|PORT_PCR_PE_MASK;
-    PORTC_PCR5=PORT_PCR_MUX(1)|PORT_PCR_PS_MASK|PORT_PCR_PE_MASK;
-    PORTC_PCR6=PORT_PCR_MUX(1)|PORT_PCR_PS_MASK|PORT_PCR_PE_MASK;
-	PORTC_PCR7=PORT_PCR_MUX(1);
-	PORTC_PCR8=PORT_PCR_MUX(1);
-	PORTC_PCR9=PORT_PCR_MUX(1);
-	PORTC_PCR10=PORT_PCR_MUX(1);
-    KEY_PORT_OUT &= ~ROWS_MASK;            /* Preset all rows to zero    */
-    // Initialize the Key Buffer and semaphore
-    keyBuffer.buffer = 0x00;           /* Init KeyBuffer      */
-    OSSemCreate(&(keyBuffer.flag),"Key Semaphore",0,&os_err);
-    while(os_err != OS_ERR_NONE){           /* Error Trap                        */
-    }
-    //Create the key task
-    OSTaskCreate((OS_TCB     *)&keyTaskTCB,
-                (CPU_CHAR   *)"uCOS Key Task ",
-                (OS_TASK_PTR ) keyTask,
-                (void       *) 0,
-                (OS_PRIO     ) APP_CFG_KEY_TASK_PRIO,
-                (CPU_STK    *)&keyTaskStk[0],
-                (CPU_STK     )(APP_CFG_KEY_TASK_STK_SIZE / 10u),
-                (CPU_STK_SIZE) APP_CFG_KEY_TASK_STK_SIZE,
-                (OS_MSG_QTY  ) 0,
-                (OS_TICK     ) 0,
-                (void       *) 0,
-                (OS_OPT      )(OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR),
-                (OS_ERR     *)&os_err);
-    while(os_err != OS_ERR_NONE){           /* Error Trap                        */
-    }
-
-}
-
-/********************************************************************
-* KeyTask() - Read the keypad and updates KeyBuffer. 
-*             A task decomposed into states for detecting and
-*             verifying keypresses. This task should be called
-*             periodically with a period greater than the worst case
-*             switch bounce time and less than the shortest switch
-*             activation time minus the bounce time. The switch must 
-*             be released to have multiple acknowledged presses.
-* (Public)
-********************************************************************/
-static void keyTask(void *p_arg) {
-
-    OS_ERR os_err;
-    INT8U cur_key;
-    INT8U last_key = 0;
-    KEYSTATES KeyState = KEY_OFF;
-    (void)p_arg;
-    while(1){
-		DB1_TURN_OFF();
-        OSTimeDly(8,OS_OPT_TIME_PERIODIC,&os_err);
-		DB1_TURN_ON();
-        while(os_err != OS_ERR_NONE){           /* Error Trap                        */
-        }
-        cur_key = keyScan();
-        if(KeyState == KEY_OFF){    /* Key released state */
-            if(cur_key != 0){
-                KeyState = KEY_EDGE;
-            }else{ /* wait for key press */
-            }
-        }else if(KeyState == KEY_EDGE){     /* Keypress detected state*/
-            if(cur_key == last_key){        /* Keypress verified */
-                KeyState = KEY_VERF;
-                keyBuffer.buffer = keyCodeTable[cur_key - 1]; /*update buffer */
-                (void)OSSemPost(&(keyBuffer.flag), OS_OPT_POST_1, &os_err);   /* Signal new data in buffer */
-                while(os_err != OS_ERR_NONE){           /* Error Trap                        */
-                }
-            }else if( cur_key == 0){        /* Unvalidated, start over */
-                KeyState = KEY_OFF;
-            }else{                          /*Unvalidated, diff key edge*/
-            }
-        }else if(KeyState == KEY_VERF){     /* Keypress verified state */
-            if((cur_key == 0) || (cur_key != last_key)){
-                KeyState = KEY_OFF;
-            }else{ /* wait for release or key change */
-            }
-        }else{ /* In case of error */
-            KeyState = KEY_OFF;             /* Should never get here */
-        }
-        last_key = cur_key;                 /* Save key for next time */
-    
-    }
-}
-
-/********************************************************************
-* keyScan() - Scans the keypad and returns a keycode.
-*           - Designed for 4x4 keypad with columns pulled high.
-*           - Current keycodes follow:
-*               1->0x01,2->0x02,3->0x03,A->0x04
-*               4->0x05,5->0x06,6->0x07,B->0x08
-*               7->0x09,8->0x0A,9->0x0B,C->0x0C
-*               *->0x0D,0->0x0E,#->0x0F,D->0x10
-*           - Returns zero if no key is pressed.
-*           - ColTable[] can be changed to distinguish multiple keys
-*             pressed in the same row.
-* (Private)
-********************************************************************/
-static INT8U keyScan(void) {
-
-    INT8U kcode;
-    INT8U roff;
-    INT32U rbit;
-
-    const INT8U ColTable[16] = {0,1,2,2,3,3,3,3,4,4,4,4,4,4,4,4};
-
-    rbit = 0x00000080;
-    roff = 0x00;
-    while(rbit != 0){ /* Until all rows are scanned */
-        KEY_PORT_OUT &= ~ROWS_MASK;
-        KEY_PORT_DIR = (KEY_PORT_DIR & ~ROWS_MASK)|rbit;    /* Pull row low */
-        keyDly();	// wait for direction and col inputs to settle
-        kcode = (INT8U)(((~KEY_PORT_IN) & COLS_MASK)>>3);  /*Read columns */
-        KEY_PORT_DIR = (KEY_PORT_DIR &~ROWS_MASK); 
-        if(kcode != 0){        /* generate key code if key pressed */
-            kcode = roff + ColTable[kcode];
-            break;
-        }
-        rbit = ROWS_MASK & (rbit<<1);       /* setup for next row */
-        roff += 4;
-    }
-    return (kcode); 
-}
-/********************************************************************
- * keyDly() a software delay for keyScan() to wait until port row
- * bit direction and column inputs are settled .
- * With debug bits included and a 120Mhz bus the delay is 
- * 	Tdly = (83.2ns)i + 128ns
- * Currently set to ~830ns with i=10.
- * TDM 01/20/2013
- *******************************************************************/
-static void keyDly(void){
-	INT32U i;
-	for(i=0;i<10;i++){
-	}
-}
+/********************************************************************
+* uCOSKey.c - A keypad module that runs under MicroC/OS for a 4x4 
+* matrix keypad.
+* This version allows for multiple column keys to be pressed and 
+* mapped to a different code by changing ColTable[] in keyScan().
+* Multiple rows can not be resolved. The topmost button will be used.
+* The keyCodeTable[] is currently set to generate ASCII codes.
+*
+* Requires the following be defined in app_cfg.h:
+*                   APP_CFG_KEY_TASK_PRIO
+*                   APP_CFG_KEY_TASK_STK_SIZE
+*
+* 02/20/2001 TDM Original key.c for 9S12
+* 01/14/2013 TDM Modified for K70 custom tower board.
+* 02/12/2013 TDM Modified to run under MicroC/OS-III
+* 01/18/2018 Changed to replace includes.h TDM
+* 02/01/2018 Brian Willis changed KeyTask() DB Bit from 4 to 1
+*
+* While no key is down all rows are driven low and the columns
+* interrupt on logic zero, so keyTask() sleeps until a press instead
+* of scanning every 8 ticks. PORTC_IRQHandler() wakes it and it scans
+* on the 8 tick debounce period until the key is released.
+*
+* Verified presses, repeats while held, long presses and releases go
+* into a ring of KEY_EVENTs. keyTask() is the only writer of the head
+* and the pending task the only writer of the tail, so the ring needs
+* no lock, and a counting semaphore holds the number of events. Repeat
+* and long press times are set in app_cfg.h.
+*********************************************************************
+* Header Files - Dependencies
+********************************************************************/
+#include "MCUType.h"
+#include "app_cfg.h"
+#include "os.h"
+#include "uCOSKey.h"
+#include "k65TWR_GPIO.h"
+/********************************************************************
+* Module Defines
+* This version is designed for the custom LCD/Keypad board, which
+* has the following mapping:
+*  COL1->PTC3, COL2->PTC4, COL3->PTC5, COL4->PTC6
+*  ROW1->PTC7, ROW2->PTC8, ROW3->PTC9, ROW4->PTC10
+********************************************************************/
+typedef enum{KEY_OFF,KEY_EDGE,KEY_VERF} KEYSTATES;
+#define KEY_PORT_OUT   GPIOC_PDOR
+#define KEY_PORT_DIR   GPIOC_PDDR
+#define KEY_PORT_IN	   GPIOC_PDIR
+#define COLS_MASK 0x00000078
+#define ROWS_MASK 0x00000780
+#define DC1 (INT8U)0x11     /*ASCII control code for the A button */
+#define DC2 (INT8U)0x12     /*ASCII control code for the B button */
+#define DC3 (INT8U)0x13     /*ASCII control code for the C button */
+#define DC4 (INT8U)0x14     /*ASCII control code for the D button */
+#define KEY_DEBOUNCE_TICKS 8u
+#define KEY_EV_Q_SIZE  16u   /*Events, must be a power of 2            */
+#define KEY_IRQC_OFF   0x0u  /*PORT_PCR_IRQC interrupt disabled       */
+#define KEY_IRQC_LOW   0x8u  /*PORT_PCR_IRQC interrupt when logic zero */
+#define KEY_IRQ_PRIO   10u   /*Below the DMA and LCD interrupts        */
+#define KEY_COLS_IRQC(irqc) do{                                         \
+        PORTC_PCR3 = (PORTC_PCR3 & ~PORT_PCR_IRQC_MASK)|PORT_PCR_IRQC(irqc); \
+        PORTC_PCR4 = (PORTC_PCR4 & ~PORT_PCR_IRQC_MASK)|PORT_PCR_IRQC(irqc); \
+        PORTC_PCR5 = (PORTC_PCR5 & ~PORT_PCR_IRQC_MASK)|PORT_PCR_IRQC(irqc); \
+        PORTC_PCR6 = (PORTC_PCR6 & ~PORT_PCR_IRQC_MASK)|PORT_PCR_IRQC(irqc); \
+    }while(0)
+typedef struct{
+    KEY_EVENT event[KEY_EV_Q_SIZE];
+    volatile INT8U head;            /* Written by keyTask() only      */
+    volatile INT8U tail;            /* Written by the pending task only */
+    INT32U dropped;
+    OS_SEM flag;
+}KEY_BUFFER;
+/********************************************************************
+* Private Resources
+********************************************************************/
+static INT8U keyScan(void);         /* Makes a single keypad scan  */
+static const INT8U keyCodeTable[16] =
+   {'1','2','3',DC1,'4','5','6',DC2,'7','8','9',DC3,'*','0','#',DC4};
+static void keyDly(void);  /* Added for GPIO to settle before read */
+static void keyIdleArm(void);
+static void keyEventPut(INT8U code, KEY_EV_TYPE type, OS_TICK time);
+static void keyTask(void *p_arg);
+static KEY_BUFFER keyBuffer;
+static OS_FLAG_GRP *keyNotifyGrp = (OS_FLAG_GRP *)0;
+static OS_FLAGS keyNotifyFlag;
+static void keyEventTake(KEY_EVENT *event);
+/**********************************************************************************
+* Allocate task control blocks
+**********************************************************************************/
+static OS_TCB keyTaskTCB;
+/*************************************************************************
+* Allocate task stack space.
+*************************************************************************/
+static CPU_STK keyTaskStk[APP_CFG_KEY_TASK_STK_SIZE];
+
+/********************************************************************
+* KeyPend() - A function to provide access to the key buffer via a
+*             semaphore. Returns the code of the next press, skipping
+*             the other events. Returns 0 on an error.
+*    - Public
+********************************************************************/
+INT8U KeyPend(INT16U tout, OS_ERR *os_err){
+    KEY_EVENT event;
+
+    do{
+        KeyEventPend(tout, &event, os_err);
+    }while((*os_err == OS_ERR_NONE) && (event.type != KEY_EV_PRESS));
+    return((*os_err == OS_ERR_NONE) ? event.code : 0);
+}
+
+/********************************************************************
+* KeyEventPend() - Waits for and takes the oldest key event.
+*                  *event is unchanged on an error.
+*    - Public
+********************************************************************/
+void KeyEventPend(INT16U tout, KEY_EVENT *event, OS_ERR *os_err){
+    (void)OSSemPend(&(keyBuffer.flag),tout, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, os_err);
+    if(*os_err == OS_ERR_NONE){
+        keyEventTake(event);
+    }else{}
+}
+
+/********************************************************************
+* KeyEventAccept() - Takes the oldest key event if there is one,
+*                    never waits. Returns TRUE if *event was filled.
+*    - Public
+********************************************************************/
+INT8U KeyEventAccept(KEY_EVENT *event){
+    OS_ERR os_err;
+    INT8U taken = FALSE;
+
+    (void)OSSemPend(&(keyBuffer.flag), 0, OS_OPT_PEND_NON_BLOCKING, (CPU_TS *)0, &os_err);
+    if(os_err == OS_ERR_NONE){
+        keyEventTake(event);
+        taken = TRUE;
+    }else{ /* OS_ERR_PEND_WOULD_BLOCK, queue empty */
+    }
+    return(taken);
+}
+
+/********************************************************************
+* KeyNotify() - Sets flag in grp after every new event as well as
+*               counting it. Call once, before KeyInit().
+*    - Public
+********************************************************************/
+void KeyNotify(OS_FLAG_GRP *grp, OS_FLAGS flag){
+    keyNotifyFlag = flag;
+    keyNotifyGrp = grp;
+}
+
+/********************************************************************
+* KeyEventsDropped() - Events lost because the queue was full
+*    - Public
+********************************************************************/
+INT32U KeyEventsDropped(void){
+    return(keyBuffer.dropped);
+}
+
+/********************************************************************
+* KeyInit() - Initialization routine for the keypad module
+*             The columns are normally set as inputs and, since they 
+*             are pulled high, they are one. Then to pull a row low
+*             during scanning, the direction for that pin is changed
+*             to an output.
+********************************************************************/
+void KeyInit(void){
+
+    OS_ERR os_err;
+	/* Key port init */
+    SIM_SCGC5 |= SIM_SCGC5_PORTC_MASK;              /* Enable clock gate for PORTC */
+    PORTC_PCR3=PORT_PCR_MUX(1)|PORT_PCR_PS_MASK|PORT_PCR_PE_MASK;
+    PORTC_PCR4=PORT_PCR_MUX(1)|PORT_PCR_PS_MASK|PORT_PCR_PE_MASK;
+    PORTC_PCR5=PORT_PCR_MUX(1)|PORT_PCR_PS_MASK|PORT_PCR_PE_MASK;
+    PORTC_PCR6=PORT_PCR_MUX(1)|PORT_PCR_PS_MASK|PORT_PCR_PE_MASK;
+	PORTC_PCR7=PORT_PCR_MUX(1);
+	PORTC_PCR8=PORT_PCR_MUX(1);
+	PORTC_PCR9=PORT_PCR_MUX(1);
+	PORTC_PCR10=PORT_PCR_MUX(1);
+    KEY_PORT_OUT &= ~ROWS_MASK;            /* Preset all rows to zero    */
+    PORTC_ISFR = COLS_MASK;
+    NVIC_SetPriority(PORTC_IRQn, KEY_IRQ_PRIO);
+    NVIC_ClearPendingIRQ(PORTC_IRQn);
+    NVIC_EnableIRQ(PORTC_IRQn);            /* Columns are armed by keyTask() */
+    // Initialize the Key Buffer and semaphore
+    keyBuffer.head = 0;                /* Init KeyBuffer      */
+    keyBuffer.tail = 0;
+    keyBuffer.dropped = 0;
+    OSSemCreate(&(keyBuffer.flag),"Key Semaphore",0,&os_err);
+    while(os_err != OS_ERR_NONE){           /* Error Trap                        */
+    }
+    //Create the key task
+    OSTaskCreate((OS_TCB     *)&keyTaskTCB,
+                (CPU_CHAR   *)"uCOS Key Task ",
+                (OS_TASK_PTR ) keyTask,
+                (void       *) 0,
+                (OS_PRIO     ) APP_CFG_KEY_TASK_PRIO,
+                (CPU_STK    *)&keyTaskStk[0],
+                (CPU_STK     )(APP_CFG_KEY_TASK_STK_SIZE / 10u),
+                (CPU_STK_SIZE) APP_CFG_KEY_TASK_STK_SIZE,
+                (OS_MSG_QTY  ) 0,
+                (OS_TICK     ) 0,
+                (void       *) 0,
+                (OS_OPT      )(OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR),
+                (OS_ERR     *)&os_err);
+    while(os_err != OS_ERR_NONE){           /* Error Trap                        */
+    }
+
+}
+
+/********************************************************************
+* KeyTask() - Read the keypad and updates KeyBuffer. 
+*             A task decomposed into states for detecting and
+*             verifying keypresses. This task should be called
+*             periodically with a period greater than the worst case
+*             switch bounce time and less than the shortest switch
+*             activation time minus the bounce time. The switch must 
+*             be released to have multiple acknowledged presses.
+*             A verified key makes a press event, then while it is
+*             held a long press event and repeat events, and a release
+*             event when it is let go or another key replaces it.
+*             Once released with no edge pending it arms the column
+*             interrupt and pends until PORTC_IRQHandler() posts, then
+*             scans at once and goes back to the debounce period.
+*             The period is a relative delay, not OS_OPT_TIME_PERIODIC,
+*             so the first scan after an idle wake still gets a full
+*             KEY_DEBOUNCE_TICKS of debounce.
+* (Public)
+********************************************************************/
+static void keyTask(void *p_arg) {
+
+    OS_ERR os_err;
+    INT8U cur_key;
+    INT8U last_key = 0;
+    KEYSTATES KeyState = KEY_OFF;
+    OS_TICK now;
+    OS_TICK press_time = 0;
+    OS_TICK next_repeat = 0;
+    INT8U long_sent = FALSE;
+    (void)p_arg;
+    while(1){
+        if((KeyState == KEY_OFF) && (last_key == 0)){   /* Idle, wait for a press */
+            keyIdleArm();
+            DB1_TURN_OFF();
+            (void)OSTaskSemPend(0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
+            DB1_TURN_ON();
+        }else{
+            DB1_TURN_OFF();
+            OSTimeDly(KEY_DEBOUNCE_TICKS,OS_OPT_TIME_DLY,&os_err);
+            DB1_TURN_ON();
+        }
+        while((os_err != OS_ERR_NONE) && (os_err != OS_ERR_TIME_ZERO_DLY)){ /* Error Trap */
+        }
+        cur_key = keyScan();
+        now = OSTimeGet(&os_err);
+        if(KeyState == KEY_OFF){    /* Key released state */
+            if(cur_key != 0){
+                KeyState = KEY_EDGE;
+            }else{ /* wait for key press */
+            }
+        }else if(KeyState == KEY_EDGE){     /* Keypress detected state*/
+            if(cur_key == last_key){        /* Keypress verified */
+                KeyState = KEY_VERF;
+                press_time = now;
+                next_repeat = now + APP_CFG_KEY_REPEAT_DLY_TICKS;
+                long_sent = FALSE;
+                keyEventPut(keyCodeTable[cur_key - 1], KEY_EV_PRESS, now);
+            }else if( cur_key == 0){        /* Unvalidated, start over */
+                KeyState = KEY_OFF;
+            }else{                          /*Unvalidated, diff key edge*/
+            }
+        }else if(KeyState == KEY_VERF){     /* Keypress verified state */
+            if((cur_key == 0) || (cur_key != last_key)){
+                KeyState = KEY_OFF;
+                keyEventPut(keyCodeTable[last_key - 1], KEY_EV_RELEASE, now);
+            }else{ /* held, wait for release or key change */
+                if((APP_CFG_KEY_LONG_TICKS != 0) && (long_sent == FALSE) &&
+                   ((now - press_time) >= APP_CFG_KEY_LONG_TICKS)){
+                    long_sent = TRUE;
+                    keyEventPut(keyCodeTable[cur_key - 1], KEY_EV_LONG, now);
+                }else{}
+                if((APP_CFG_KEY_REPEAT_DLY_TICKS != 0) &&
+                   ((OS_TICK)(now - next_repeat) < ((OS_TICK)1 << 31))){   /* now >= next_repeat */
+                    next_repeat += APP_CFG_KEY_REPEAT_TICKS;
+                    keyEventPut(keyCodeTable[cur_key - 1], KEY_EV_REPEAT, now);
+                }else{}
+            }
+        }else{ /* In case of error */
+            KeyState = KEY_OFF;             /* Should never get here */
+        }
+        last_key = cur_key;                 /* Save key for next time */
+    
+    }
+}
+
+/********************************************************************
+* keyScan() - Scans the keypad and returns a keycode.
+*           - Designed for 4x4 keypad with columns pulled high.
+*           - Current keycodes follow:
+*               1->0x01,2->0x02,3->0x03,A->0x04
+*               4->0x05,5->0x06,6->0x07,B->0x08
+*               7->0x09,8->0x0A,9->0x0B,C->0x0C
+*               *->0x0D,0->0x0E,#->0x0F,D->0x10
+*           - Returns zero if no key is pressed.
+*           - ColTable[] can be changed to distinguish multiple keys
+*             pressed in the same row.
+* (Private)
+********************************************************************/
+static INT8U keyScan(void) {
+
+    INT8U kcode;
+    INT8U roff;
+    INT32U rbit;
+
+    const INT8U ColTable[16] = {0,1,2,2,3,3,3,3,4,4,4,4,4,4,4,4};
+
+    rbit = 0x00000080;
+    roff = 0x00;
+    while(rbit != 0){ /* Until all rows are scanned */
+        KEY_PORT_OUT &= ~ROWS_MASK;
+        KEY_PORT_DIR = (KEY_PORT_DIR & ~ROWS_MASK)|rbit;    /* Pull row low */
+        keyDly();	// wait for direction and col inputs to settle
+        kcode = (INT8U)(((~KEY_PORT_IN) & COLS_MASK)>>3);  /*Read columns */
+        KEY_PORT_DIR = (KEY_PORT_DIR &~ROWS_MASK); 
+        if(kcode != 0){        /* generate key code if key pressed */
+            kcode = roff + ColTable[kcode];
+            break;
+        }
+        rbit = ROWS_MASK & (rbit<<1);       /* setup for next row */
+        roff += 4;
+    }
+    return (kcode); 
+}
+/********************************************************************
+* keyEventPut() - Adds an event to the ring and counts it on the
+*                 semaphore. If the ring is full the event is dropped,
+*                 older events are kept. keyTask() only.
+* (Private)
+********************************************************************/
+static void keyEventPut(INT8U code, KEY_EV_TYPE type, OS_TICK time){
+    OS_ERR os_err;
+    INT8U head = keyBuffer.head;
+    INT8U next = (head + 1u) & (KEY_EV_Q_SIZE - 1u);
+
+    if(next != keyBuffer.tail){
+        keyBuffer.event[head].code = code;
+        keyBuffer.event[head].type = type;
+        keyBuffer.event[head].time = time;
+        __DMB();                        /* Entry written before it is published */
+        keyBuffer.head = next;                  /* Publishes the entry */
+        (void)OSSemPost(&(keyBuffer.flag), OS_OPT_POST_1, &os_err);   /* Signal new data in buffer */
+        while(os_err != OS_ERR_NONE){           /* Error Trap                        */
+        }
+        if(keyNotifyGrp != (OS_FLAG_GRP *)0){
+            (void)OSFlagPost(keyNotifyGrp, keyNotifyFlag, OS_OPT_POST_FLAG_SET, &os_err);
+            while(os_err != OS_ERR_NONE){       /* Error Trap                        */
+            }
+        }else{}
+    }else{
+        keyBuffer.dropped++;
+    }
+}
+
+/********************************************************************
+* keyEventTake() - Copies out and frees the oldest entry, after a
+*                  successful pend on the semaphore.
+* (Private)
+********************************************************************/
+static void keyEventTake(KEY_EVENT *event){
+    INT8U tail = keyBuffer.tail;
+
+    *event = keyBuffer.event[tail];
+    __DMB();                        /* Copy done before the entry is freed */
+    keyBuffer.tail = (tail + 1u) & (KEY_EV_Q_SIZE - 1u);    /* Frees the entry */
+}
+
+/********************************************************************
+* keyIdleArm() - Drives every row low and arms the column interrupt,
+*                a press on any key then pulls its column low. The
+*                interrupt is level triggered, so a key already down
+*                when armed interrupts at once.
+* (Private)
+********************************************************************/
+static void keyIdleArm(void){
+    KEY_PORT_OUT &= ~ROWS_MASK;
+    KEY_PORT_DIR |= ROWS_MASK;
+    keyDly();                               /* Let the columns settle */
+    PORTC_ISFR = COLS_MASK;
+    KEY_COLS_IRQC(KEY_IRQC_LOW);
+}
+
+/********************************************************************
+* PORTC_IRQHandler() - Column interrupt, a key was pressed while idle.
+*                      Disarms the columns, since the level holds while
+*                      the key is down, and wakes keyTask().
+* (Public ISR)
+********************************************************************/
+void PORTC_IRQHandler(void){
+    OS_ERR os_err;
+
+    OSIntEnter();
+    KEY_COLS_IRQC(KEY_IRQC_OFF);
+    PORTC_ISFR = COLS_MASK;
+    (void)OSTaskSemPost(&keyTaskTCB, OS_OPT_POST_NONE, &os_err);
+    while(os_err != OS_ERR_NONE){           /* Error Trap                        */
+    }
+    OSIntExit();
+}
+
+/********************************************************************
+ * keyDly() a software delay for keyScan() to wait until port row
+ * bit direction and column inputs are settled .
+ * With debug bits included and a 120Mhz bus the delay is 
+ * 	Tdly = (83.2ns)i + 128ns
+ * Currently set to ~830ns with i=10.
+ * TDM 01/20/2013
+ *******************************************************************/
+static void keyDly(void){
+	INT32U i;
+	for(i=0;i<10;i++){
+	}
+}
@@ -1,17 +1,46 @@
-/********************************************************************
-* KeyUcos.h - The header file for the keypad module, KeyUcos.c
-* 02/15/2006 Todd Morton
-*********************************************************************
-* Public Resources
-********************************************************************/
-#ifndef UC_KEY_DEF
-#define UC_KEY_DEF
-
-INT8U KeyPend(INT16U tout, OS_ERR *os_err); /* Pend on key press*/
-                             /* tout - semaphore timeout           */
-                             /* *err - destination of err code     */
-                             /* Error codes are identical to a semaphore */
-
-void KeyInit(void);             /* Keypad Initialization    */
-
-#endif
+/********************************************************************
+* KeyUcos.h - The header file for the keypad module, KeyUcos.c
+* 02/15/2006 Todd Morton
+*********************************************************************
+* Public Resources
+********************************************************************/
+#ifndef UC_KEY_DEF
+#define UC_KEY_DEF
+
+typedef enum{KEY_EV_PRESS, KEY_EV_REPEAT, KEY_EV_LONG, KEY_EV_RELEASE} KEY_EV_TYPE;
+
+typedef struct{
+    INT8U code;                  /* keyCodeTable[] code of the key     */
+    KEY_EV_TYPE type;
+    OS_TICK time;                /* OSTimeGet() when the event was seen */
+}KEY_EVENT;
+
+INT8U KeyPend(INT16U tout, OS_ERR *os_err); /* Pend on key press*/
+                             /* tout - semaphore timeout           */
+                             /* *err - destination of err code     */
+                             /* Error codes are identical to a semaphore */
+                             /* Other events are skipped, tout     */
+                             /* restarts for each one              */
+
+void KeyEventPend(INT16U tout, KEY_EVENT *event, OS_ERR *os_err);
+                             /* Pend on the next key event         */
+                             /* Only one task may take key events, */
+                             /* with either function               */
+
+INT8U KeyEventAccept(KEY_EVENT *event);
+                             /* Takes an event without waiting,    */
+                             /* FALSE if there is none             */
+
+void KeyNotify(OS_FLAG_GRP *grp, OS_FLAGS flag);
+                             /* Also set flag in grp for each new  */
+                             /* event, so a task can wait on keys  */
+                             /* and other inputs together. Call    */
+                             /* once, before KeyInit()             */
+
+INT32U KeyEventsDropped(void);  /* Events lost to a full queue      */
+
+void KeyInit(void);             /* Keypad Initialization    */
+
+void PORTC_IRQHandler(void);    /* Column interrupt, wakes the key task */
+
+#endif
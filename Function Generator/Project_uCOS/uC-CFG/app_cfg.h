@@ -1,77 +1,115 @@
-/*
-*********************************************************************************************************
-*                                              EXAMPLE CODE
-*
-*                              (c) Copyright 2013; Micrium, Inc.; Weston, FL
-*
-*               All rights reserved.  Protected by international copyright laws.
-*               Knowledge of the source code may NOT be used to develop a similar product.
-*               Please help us continue to provide the Embedded community with the finest
-*               software available.  Your honesty is greatly appreciated.
-*********************************************************************************************************
-*/
-
-/*
-*********************************************************************************************************
-*                                      APPLICATION CONFIGURATION
-*
-*                                        Freescale Kinetis K60
-*                                               on the
-*
-*                                        Freescale TWR-K60N512
-*                                          Evaluation Board
-*
-* Filename      : app_cfg.h
-* Version       : V1.00
-* Programmer(s) : DC
-*********************************************************************************************************
-*/
-
-#ifndef  APP_CFG_MODULE_PRESENT
-#define  APP_CFG_MODULE_PRESENT
-
-
-/*
-*********************************************************************************************************
-*                                       ADDITIONAL uC/MODULE ENABLES
-*********************************************************************************************************
-*/
-
-#define  APP_CFG_SERIAL_EN                          DEF_DISABLED //Change to disabled. TDM
-
-
-/*
-*********************************************************************************************************
-*                                            TASK PRIORITIES
-*********************************************************************************************************
-*/
-
-#define APP_CFG_TASK_START_PRIO         2u
-#define APP_CFG_PROCESS_TASK_PRIO		3u
-#define APP_CFG_KEY_TASK_PRIO           6u
-#define APP_CFG_TSI_TASK_PRIO		    12u
-#define APP_CFG_UITSISRV_TASK_PRIO      13u
-#define APP_CFG_UIKEYSRV_TASK_PRIO      14u
-#define APP_CFG_UI_TASK_PRIO            15u
-#define APP_CFG_LCD_TASK_PRIO 			16u
-
-/*
-*********************************************************************************************************
-*                                            TASK STACK SIZES
-*********************************************************************************************************
-*/
-
-#define APP_CFG_TASK_START_STK_SIZE     128u
-#define APP_CFG_UITASK_STK_SIZE         128u
-#define APP_CFG_LCD_TASK_STK_SIZE       128u
-#define APP_CFG_KEY_TASK_STK_SIZE       128u
-#define APP_CFG_TIMETASK_STK_SIZE       128u
-#define APP_CFG_UITSISRV_TASK_STK_SIZE  128u
-#define APP_CFG_UIKEYSRV_TASK_STK_SIZE  128u
-#define APP_CFG_PROCESS_TASK_STK_SIZE   128u
-#define APP_CFG_UI_TASK_STK_SIZE        128u
-#define APP_CFG_TSI_TASK_STK_SIZE       128u
-
-
-
-#endif
+/*
+*********************************************************************************************************
+*                                              EXAMPLE CODE
+*
+*                              (c) Copyright 2013; Micrium, Inc.; Weston, FL
+*
+*               All rights reserved.  Protected by international copyright laws.
+*               Knowledge of the source code may NOT be used to develop a similar product.
+*               Please help us continue to provide the Embedded community with the finest
+*               software available.  Your honesty is greatly appreciated.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                      APPLICATION CONFIGURATION
+*
+*                                        Freescale Kinetis K60
+*                                               on the
+*
+*                                        Freescale TWR-K60N512
+*                                          Evaluation Board
+*
+* Filename      : app_cfg.h
+* Version       : V1.00
+* Programmer(s) : DC
+*********************************************************************************************************
+*/
+
+#ifndef  APP_CFG_MODULE_PRESENT
+#define  APP_CFG_MODULE_PRESENT
+
+
+/*
+*********************************************************************************************************
+*                                       ADDITIONAL uC/MODULE ENABLES
+*********************************************************************************************************
+*/
+
+#define  APP_CFG_SERIAL_EN                          DEF_ENABLED  //SCPI commands on UART2, see Scpi.h
+#define  APP_CFG_WAVE_BENCH_EN                      DEF_DISABLED //Time Wave.c renders at startup, trap if over limit
+#define  APP_CFG_DIAG_EN                            DEF_ENABLED  //Task load/stack layer on 'C', turns on OS_CFG_DBG_EN
+#define  APP_CFG_TRACE_EN                           DEF_DISABLED //Record debug bits and kernel events (OS_CFG_TRACE_EN) in Trace.c
+#define  APP_CFG_DMA_LAT_EN                         DEF_DISABLED //DMA interrupt latency histogram in DMA.c
+#define  APP_CFG_LCD_BENCH_EN                       DEF_DISABLED //Worst case LCD flatten cycles by changed cells
+#define  APP_CFG_LCD_BUSY_FLAG_EN                   DEF_DISABLED //Poll LCD busy flag, needs R/W on PTD0
+#define  APP_CFG_LCD_EMU_EN                         DEF_DISABLED //Feed LCD writes to the LcdEmu.c display model
+
+
+/*
+*********************************************************************************************************
+*                                            TASK PRIORITIES
+*********************************************************************************************************
+*/
+
+#define APP_CFG_TASK_START_PRIO         2u
+#define APP_CFG_PROCESS_TASK_PRIO		3u
+#define APP_CFG_KEY_TASK_PRIO           6u
+#define APP_CFG_SCPI_TASK_PRIO          12u
+#define APP_CFG_UI_TASK_PRIO            15u
+#define APP_CFG_LCD_TASK_PRIO 			16u
+#define APP_CFG_DIAG_TASK_PRIO          17u
+
+/*
+*********************************************************************************************************
+*                                            TASK STACK SIZES
+*********************************************************************************************************
+*/
+
+#define APP_CFG_TASK_START_STK_SIZE     128u
+#define APP_CFG_UITASK_STK_SIZE         128u
+#define APP_CFG_LCD_TASK_STK_SIZE       128u
+#define APP_CFG_KEY_TASK_STK_SIZE       128u
+#define APP_CFG_TIMETASK_STK_SIZE       128u
+#define APP_CFG_PROCESS_TASK_STK_SIZE   128u
+#define APP_CFG_UI_TASK_STK_SIZE        128u
+#define APP_CFG_DIAG_TASK_STK_SIZE      128u
+#define APP_CFG_SCPI_TASK_STK_SIZE      256u
+
+/*
+*********************************************************************************************************
+*                                            KEYPAD TIMING
+*                                  Ticks, rounded up to the 8 tick key scan
+*********************************************************************************************************
+*/
+
+#define APP_CFG_KEY_REPEAT_DLY_TICKS    500u    //Hold before the first repeat, 0 disables repeat
+#define APP_CFG_KEY_REPEAT_TICKS        100u    //Between repeats
+#define APP_CFG_KEY_LONG_TICKS          1000u   //Hold for a long press event, 0 disables
+
+/*
+*********************************************************************************************************
+*                                            TOUCH AMPLITUDE GESTURE
+*                                  Ticks, each electrode is rescanned every 40
+*********************************************************************************************************
+*/
+
+#define APP_CFG_TOUCH_HOLD_DLY_TICKS    150u    //Hold before the amplitude starts to run
+#define APP_CFG_TOUCH_STEP_TICKS        80u     //First step period once running
+#define APP_CFG_TOUCH_STEP_ACCEL_TICKS  15u     //Taken off the period every step
+#define APP_CFG_TOUCH_STEP_MIN_TICKS    15u     //Fastest step period
+
+/*
+*********************************************************************************************************
+*                                            SERIAL COMMANDS
+*                                                 Ticks
+*********************************************************************************************************
+*/
+
+#define APP_CFG_SCPI_IDLE_POLL_TICKS    10u     //Receive ring poll once input has stopped, 1 while it comes
+#define APP_CFG_SCPI_SWEEP_STEP_TICKS   10u     //Between sweep frequency steps
+
+
+
+#endif
@@ -0,0 +1,114 @@
+/*
+************************************************************************************************************************
+*                                           uC/OS-III TRACE RECORDER EVENTS
+*
+* File    : os_trace_events.h
+*
+* Note(s) : (1) Maps the uC/OS-III OS_TRACE_xxx hooks onto the Trace.c ring buffer (see Trace.h for the record layout).
+*               Only the hooks needed for CPU time, blocking time and ISR timing are recorded, the rest stay empty
+*               from os_trace.h. Each hook is one TraceEvent() call, about 30 cycles.
+*
+*           (2) Record fields for kernel events:
+*                   arg  - priority of the task the event is about, or of the running task for post/pend events
+*                   data - ID given to the task or kernel object when it was created, 0 if the table was full
+*               traceObjNames[ID] holds the name pointer passed at create time so a decoder can name the IDs.
+*
+*           (3) Mutex and semaphore pends produce PEND_BLOCK when the task has to wait and PEND once it owns the
+*               object, so the blocking time on a key is the time between the two for the same task.
+************************************************************************************************************************
+*/
+
+#ifndef  OS_TRACE_EVENTS_H
+#define  OS_TRACE_EVENTS_H
+
+/*
+************************************************************************************************************************
+*                                                  EVENT IDS (0x10 - 0x3F)
+************************************************************************************************************************
+*/
+
+#define  TRACE_ID_OS_TASK_CREATE          0x10u
+#define  TRACE_ID_OS_TASK_SWITCH          0x11u
+#define  TRACE_ID_OS_TASK_READY           0x12u
+#define  TRACE_ID_OS_TASK_DLY             0x13u
+#define  TRACE_ID_OS_PRIO_INHERIT         0x14u
+#define  TRACE_ID_OS_PRIO_DISINHERIT      0x15u
+
+#define  TRACE_ID_OS_ISR_ENTER            0x20u          /* arg is the active vector number                          */
+#define  TRACE_ID_OS_ISR_EXIT             0x21u
+#define  TRACE_ID_OS_ISR_EXIT_TO_SCHED    0x22u
+
+#define  TRACE_ID_OS_OBJ_CREATE           0x28u
+
+#define  TRACE_ID_OS_SEM_POST             0x30u
+#define  TRACE_ID_OS_SEM_PEND             0x31u
+#define  TRACE_ID_OS_SEM_PEND_BLOCK       0x32u
+#define  TRACE_ID_OS_MUTEX_POST           0x33u
+#define  TRACE_ID_OS_MUTEX_PEND           0x34u
+#define  TRACE_ID_OS_MUTEX_PEND_BLOCK     0x35u
+#define  TRACE_ID_OS_Q_POST               0x36u
+#define  TRACE_ID_OS_Q_PEND               0x37u
+#define  TRACE_ID_OS_Q_PEND_BLOCK         0x38u
+#define  TRACE_ID_OS_TASK_SEM_POST        0x39u
+#define  TRACE_ID_OS_TASK_SEM_PEND        0x3Au
+#define  TRACE_ID_OS_TASK_SEM_PEND_BLOCK  0x3Bu
+#define  TRACE_ID_OS_TASK_Q_POST          0x3Cu
+#define  TRACE_ID_OS_TASK_Q_PEND          0x3Du
+#define  TRACE_ID_OS_TASK_Q_PEND_BLOCK    0x3Eu
+
+/*
+************************************************************************************************************************
+*                                                  RECORDER (Trace.c)
+************************************************************************************************************************
+*/
+
+void        TraceEvent       (CPU_INT08U id, CPU_INT08U arg, CPU_INT16U data);
+CPU_INT16U  TraceObjRegister (CPU_INT08U id, CPU_INT08U arg, const CPU_CHAR *p_name);
+
+#define  TRACE_OS_CUR_PRIO()             (OSTCBCurPtr->Prio)
+#define  TRACE_OS_ISR_VECT()             ((CPU_INT08U)(CPU_REG_NVIC_ICSR & 0xFFu))
+
+/*
+************************************************************************************************************************
+*                                                   uC/OS-III HOOKS
+************************************************************************************************************************
+*/
+
+#define  OS_TRACE_ISR_ENTER()                            TraceEvent(TRACE_ID_OS_ISR_ENTER, TRACE_OS_ISR_VECT(), 0u)
+#define  OS_TRACE_ISR_EXIT()                             TraceEvent(TRACE_ID_OS_ISR_EXIT, 0u, 0u)
+#define  OS_TRACE_ISR_EXIT_TO_SCHEDULER()                TraceEvent(TRACE_ID_OS_ISR_EXIT_TO_SCHED, 0u, 0u)
+
+#define  OS_TRACE_TASK_SWITCHED_IN(p_tcb)                TraceEvent(TRACE_ID_OS_TASK_SWITCH, (p_tcb)->Prio, (p_tcb)->TaskID)
+#define  OS_TRACE_TASK_READY(p_tcb)                      TraceEvent(TRACE_ID_OS_TASK_READY, (p_tcb)->Prio, (p_tcb)->TaskID)
+#define  OS_TRACE_TASK_DLY(dly_ticks)                    TraceEvent(TRACE_ID_OS_TASK_DLY, TRACE_OS_CUR_PRIO(), (CPU_INT16U)(dly_ticks))
+
+#define  OS_TRACE_MUTEX_TASK_PRIO_INHERIT(p_tcb, prio)     TraceEvent(TRACE_ID_OS_PRIO_INHERIT, (prio), (p_tcb)->TaskID)
+#define  OS_TRACE_MUTEX_TASK_PRIO_DISINHERIT(p_tcb, prio)  TraceEvent(TRACE_ID_OS_PRIO_DISINHERIT, (prio), (p_tcb)->TaskID)
+
+#define  OS_TRACE_SEM_CREATE(p_sem, p_name)              ((p_sem)->SemID = TraceObjRegister(TRACE_ID_OS_OBJ_CREATE, 0u, (p_name)))
+#define  OS_TRACE_SEM_POST(p_sem)                        TraceEvent(TRACE_ID_OS_SEM_POST, TRACE_OS_CUR_PRIO(), (p_sem)->SemID)
+#define  OS_TRACE_SEM_PEND(p_sem)                        TraceEvent(TRACE_ID_OS_SEM_PEND, TRACE_OS_CUR_PRIO(), (p_sem)->SemID)
+#define  OS_TRACE_SEM_PEND_BLOCK(p_sem)                  TraceEvent(TRACE_ID_OS_SEM_PEND_BLOCK, TRACE_OS_CUR_PRIO(), (p_sem)->SemID)
+
+#define  OS_TRACE_MUTEX_CREATE(p_mutex, p_name)          ((p_mutex)->MutexID = TraceObjRegister(TRACE_ID_OS_OBJ_CREATE, 0u, (p_name)))
+#define  OS_TRACE_MUTEX_POST(p_mutex)                    TraceEvent(TRACE_ID_OS_MUTEX_POST, TRACE_OS_CUR_PRIO(), (p_mutex)->MutexID)
+#define  OS_TRACE_MUTEX_PEND(p_mutex)                    TraceEvent(TRACE_ID_OS_MUTEX_PEND, TRACE_OS_CUR_PRIO(), (p_mutex)->MutexID)
+#define  OS_TRACE_MUTEX_PEND_BLOCK(p_mutex)              TraceEvent(TRACE_ID_OS_MUTEX_PEND_BLOCK, TRACE_OS_CUR_PRIO(), (p_mutex)->MutexID)
+
+#define  OS_TRACE_Q_CREATE(p_q, p_name)                  ((p_q)->MsgQ.MsgQID = TraceObjRegister(TRACE_ID_OS_OBJ_CREATE, 0u, (p_name)))
+#define  OS_TRACE_Q_POST(p_q)                            TraceEvent(TRACE_ID_OS_Q_POST, TRACE_OS_CUR_PRIO(), (p_q)->MsgQ.MsgQID)
+#define  OS_TRACE_Q_PEND(p_q)                            TraceEvent(TRACE_ID_OS_Q_PEND, TRACE_OS_CUR_PRIO(), (p_q)->MsgQ.MsgQID)
+#define  OS_TRACE_Q_PEND_BLOCK(p_q)                      TraceEvent(TRACE_ID_OS_Q_PEND_BLOCK, TRACE_OS_CUR_PRIO(), (p_q)->MsgQ.MsgQID)
+
+                                                         /* Called right after OS_TRACE_TASK_CREATE(), which has no name  */
+#define  OS_TRACE_TASK_SEM_CREATE(p_tcb, p_name)         ((p_tcb)->TaskID = TraceObjRegister(TRACE_ID_OS_TASK_CREATE, (p_tcb)->Prio, (p_name)))
+#define  OS_TRACE_TASK_SEM_POST(p_tcb)                   TraceEvent(TRACE_ID_OS_TASK_SEM_POST, TRACE_OS_CUR_PRIO(), (p_tcb)->TaskID)
+#define  OS_TRACE_TASK_SEM_PEND(p_tcb)                   TraceEvent(TRACE_ID_OS_TASK_SEM_PEND, TRACE_OS_CUR_PRIO(), (p_tcb)->TaskID)
+#define  OS_TRACE_TASK_SEM_PEND_BLOCK(p_tcb)             TraceEvent(TRACE_ID_OS_TASK_SEM_PEND_BLOCK, TRACE_OS_CUR_PRIO(), (p_tcb)->TaskID)
+
+#define  OS_TRACE_TASK_MSG_Q_CREATE(p_msg_q, p_name)     ((p_msg_q)->MsgQID = TraceObjRegister(TRACE_ID_OS_OBJ_CREATE, 0u, (p_name)))
+#define  OS_TRACE_TASK_MSG_Q_POST(p_msg_q)               TraceEvent(TRACE_ID_OS_TASK_Q_POST, TRACE_OS_CUR_PRIO(), (p_msg_q)->MsgQID)
+#define  OS_TRACE_TASK_MSG_Q_PEND(p_msg_q)               TraceEvent(TRACE_ID_OS_TASK_Q_PEND, TRACE_OS_CUR_PRIO(), (p_msg_q)->MsgQID)
+#define  OS_TRACE_TASK_MSG_Q_PEND_BLOCK(p_msg_q)         TraceEvent(TRACE_ID_OS_TASK_Q_PEND_BLOCK, TRACE_OS_CUR_PRIO(), (p_msg_q)->MsgQID)
+
+#endif
@@ -1,119 +1,298 @@
-/*******************************************************************************
-* DMA.c -   A module of initializing DMA0, DAC0, and PIT0 to feed 12bit values
-*           for a sinusoidal wave of 300Hz with 4 harmonies at 600Hz, 900Hz,
-*           1200Hz, and 1500Hz. These values are taken by the DMA to the DAC
-*           with triggers from the PIT.
-*
-* Created on: Dec 7, 2017
-* Author: Anthony Needles
-*******************************************************************************/
-#include "MCUType.h"
-#include "K65TWR_GPIO.h"
-#include "app_cfg.h"
-#include "os.h"
-#include "Wave.h"
-#include "DMA.h"
-
-static INT8U dmaBufferRdyIndex;
-static OS_SEM dmaBufferDoneFlag;
-
-INT16U wavCurSamples[DMA_TWOBLOCKS][DMA_64SAMPLES_PERBLOCK];
-
-/********************************************************************
-* DMAInit - Initializes DMA0
-*
-* Description:  Enables DMA for use with transferring data in dmaWaveTable to
-*               DAC0. Uses PIT0 for triggering. Disables the DMAMUX, the gives
-*               the source table address, 16bit data size, 2byte increments, -128
-*               end address change (return to original address). For destination
-*               the address is the DAC0 data register, 0 byte offset, 16 bit size.
-*               Minor loop size increment of 2 byes, with 64 samples total.
-*               Scatter/gather processing turned on. The DMAMUX is then reenabled
-*               with DMAMUX 0 selected.
-*
-*
-*
-* Return value: None
-*
-* Arguments:    None
-********************************************************************/
-void DMAInit(INT16U *out_block){
-    OS_ERR os_err;
-    OSSemCreate(&dmaBufferDoneFlag, "Buffer Done Flag", 0,&os_err);
-    while(os_err != OS_ERR_NONE){}
-
-    dmaBufferRdyIndex = 1;
-
-    SIM_SCGC6 |= SIM_SCGC6_DMAMUX_MASK;
-    SIM_SCGC7 |= SIM_SCGC7_DMA_MASK;
-
-    DMAMUX_CHCFG(0) |= (DMAMUX_CHCFG_ENBL(0)|DMAMUX_CHCFG_TRIG(0));
-    DMA_SADDR(0) = DMA_SADDR_SADDR(out_block);
-    DMA_ATTR(0) = (DMA_ATTR_SSIZE(DMA_16BIT_SAMPLES) | DMA_ATTR_SMOD(0) | DMA_ATTR_DMOD(0) | DMA_ATTR_DSIZE(DMA_16BIT_SAMPLES));
-    DMA_SOFF(0) = DMA_SOFF_SOFF(DMA_2BYTES_PERSAMPLE);
-    DMA_TCD0_NBYTES_MLNO = DMA_NBYTES_MLNO_NBYTES(DMA_2BYTES_PERSAMPLE);
-    DMA_CITER_ELINKNO(0) = DMA_CITER_ELINKNO_ELINK(0)|DMA_CITER_ELINKNO_CITER(DMA_TWOBLOCKS*DMA_64SAMPLES_PERBLOCK);
-    DMA_BITER_ELINKNO(0) = DMA_BITER_ELINKNO_ELINK(0)|DMA_BITER_ELINKNO_BITER(DMA_TWOBLOCKS*DMA_64SAMPLES_PERBLOCK);
-    DMA_SLAST(0) = DMA_SLAST_SLAST(-(DMA_256BYTES_PERBUFFER));
-    DMA_DADDR(0) = DMA_DADDR_DADDR(&DAC0_DAT0L);
-    DMA_DOFF(0) = DMA_DOFF_DOFF(0);
-    DMA_DLAST_SGA(0) = DMA_DLAST_SGA_DLASTSGA(0);
-    DMA_TCD0_CSR = DMA_CSR_ESG(0) | DMA_CSR_MAJORELINK(0) | DMA_CSR_BWC(3) | DMA_CSR_INTHALF(1) | DMA_CSR_INTMAJOR(1) | DMA_CSR_DREQ(0);
-    DMAMUX_CHCFG(0) = DMAMUX_CHCFG_ENBL(1)|DMAMUX_CHCFG_TRIG(1)|DMAMUX_CHCFG_SOURCE(60);
-    NVIC_EnableIRQ(0);
-    DMA_SERQ = DMA_SERQ_SERQ(0);
-
-}
-/********************************************************************
-* DMADAC0Init - Initializes DAC0
-*
-* Description:  Enables DAC system, software trigger, and VDDA reference. Also
-*               enables DMA and DAC buffer.
-*
-* Return value: None
-*
-* Arguments:    None
-********************************************************************/
-void DMADAC0Init(void){
-    SIM_SCGC2 = (SIM_SCGC2 | SIM_SCGC2_DAC0(1));
-    DAC0_C0 |= DAC_C0_DACEN(1) | DAC_C0_DACRFS(0) | DAC_C0_DACTRGSEL(1);
-    DAC0_C1 |= (DAC_C1_DMAEN(1) | DAC_C1_DACBFEN(1));
-    VREF_SC = VREF_SC_VREFEN(1)| VREF_SC_MODE_LV(1);
-}
-/********************************************************************
-* DMAPIT0Init - Initializes PIT0
-*
-* Description:  Enables PIT clock 0. Enables all standard timers. Enables
-*               PIT0 timer and PIT0 timer interrupt. Triggers at 300Hz.
-*
-* Return value: None
-*
-* Arguments:    None
-********************************************************************/
-void DMAPIT0Init(void){
-    SIM_SCGC6 = (SIM_SCGC6 | SIM_SCGC6_PIT(1));
-    PIT_MCR = PIT_MCR_MDIS(0);
-    PIT_TCTRL0 = (PIT_TCTRL0 | PIT_TCTRL_TIE(1) | PIT_TCTRL_TEN(1));
-    PIT_LDVAL0 = PIT0_TIMER_VALUE;
-}
-
-void DMA0_DMA16_IRQHandler(void){
-    OS_ERR os_err;
-
-    OSIntEnter();
-    DMA_CINT = DMA_CINT_CINT(0);
-    if(dmaBufferRdyIndex == 1){
-        dmaBufferRdyIndex = 0;
-    } else{
-        dmaBufferRdyIndex = 1;
-    }
-    (void)OSSemPost(&dmaBufferDoneFlag, OS_OPT_POST_1, &os_err);
-    while(os_err != OS_ERR_NONE){}
-
-    OSIntExit();
-}
-
-INT8U DMABlockDonePend(OS_ERR *os_err){
-    (void)OSSemPend(&dmaBufferDoneFlag,0,OS_OPT_PEND_BLOCKING,(CPU_TS *)0, os_err);
-    return dmaBufferRdyIndex;
-}
+/*******************************************************************************
+* DMA.c -   A module of initializing DMA0, DAC0, and PIT0 to feed 12bit values
+*           for a sinusoidal wave of 300Hz with 4 harmonies at 600Hz, 900Hz,
+*           1200Hz, and 1500Hz. These values are taken by the DMA to the DAC
+*           with triggers from the PIT.
+*
+* Created on: Dec 7, 2017
+* Author: Anthony Needles
+*******************************************************************************/
+#include "MCUType.h"
+#include "K65TWR_GPIO.h"
+#include "app_cfg.h"
+#include "os.h"
+#include "Wave.h"
+#include "DMA.h"
+#include "Trace.h"
+
+static INT8U dmaBufferRdyIndex;
+static OS_SEM dmaBufferDoneFlag;
+static OS_FLAG_GRP *dmaNotifyGrp = (OS_FLAG_GRP *)0;
+static OS_FLAGS dmaNotifyFlag;
+
+#if (APP_CFG_DMA_LAT_EN == DEF_ENABLED)
+static INT32U dmaLatHist[DMA_LAT_NUM_BINS];
+static INT32U dmaLatCnt;
+static INT32U dmaLatMax;
+
+static void dmaLatRecord(void);
+#endif
+
+INT16U wavCurSamples[DMA_TWOBLOCKS][DMA_64SAMPLES_PERBLOCK];
+
+/********************************************************************
+* DMAInit - Initializes DMA0
+*
+* Description:  Enables DMA for use with transferring data in dmaWaveTable to
+*               DAC0. Uses PIT0 for triggering. Disables the DMAMUX, the gives
+*               the source table address, 16bit data size, 2byte increments, -128
+*               end address change (return to original address). For destination
+*               the address is the DAC0 data register, 0 byte offset, 16 bit size.
+*               Minor loop size increment of 2 byes, with 64 samples total.
+*               Scatter/gather processing turned on. The DMAMUX is then reenabled
+*               with DMAMUX 0 selected.
+*
+*
+*
+* Return value: None
+*
+* Arguments:    None
+********************************************************************/
+void DMAInit(INT16U *out_block){
+    OS_ERR os_err;
+    OSSemCreate(&dmaBufferDoneFlag, "Buffer Done Flag", 0,&os_err);
+    while(os_err != OS_ERR_NONE){}
+
+    dmaBufferRdyIndex = 1;
+
+    SIM_SCGC6 |= SIM_SCGC6_DMAMUX_MASK;
+    SIM_SCGC7 |= SIM_SCGC7_DMA_MASK;
+
+    DMAMUX_CHCFG(0) |= (DMAMUX_CHCFG_ENBL(0)|DMAMUX_CHCFG_TRIG(0));
+    DMA_SADDR(0) = DMA_SADDR_SADDR(out_block);
+    DMA_ATTR(0) = (DMA_ATTR_SSIZE(DMA_16BIT_SAMPLES) | DMA_ATTR_SMOD(0) | DMA_ATTR_DMOD(0) | DMA_ATTR_DSIZE(DMA_16BIT_SAMPLES));
+    DMA_SOFF(0) = DMA_SOFF_SOFF(DMA_2BYTES_PERSAMPLE);
+    DMA_TCD0_NBYTES_MLNO = DMA_NBYTES_MLNO_NBYTES(DMA_2BYTES_PERSAMPLE);
+    DMA_CITER_ELINKNO(0) = DMA_CITER_ELINKNO_ELINK(0)|DMA_CITER_ELINKNO_CITER(DMA_TWOBLOCKS*DMA_64SAMPLES_PERBLOCK);
+    DMA_BITER_ELINKNO(0) = DMA_BITER_ELINKNO_ELINK(0)|DMA_BITER_ELINKNO_BITER(DMA_TWOBLOCKS*DMA_64SAMPLES_PERBLOCK);
+    DMA_SLAST(0) = DMA_SLAST_SLAST(-(DMA_256BYTES_PERBUFFER));
+    DMA_DADDR(0) = DMA_DADDR_DADDR(&DAC0_DAT0L);
+    DMA_DOFF(0) = DMA_DOFF_DOFF(0);
+    DMA_DLAST_SGA(0) = DMA_DLAST_SGA_DLASTSGA(0);
+    DMA_TCD0_CSR = DMA_CSR_ESG(0) | DMA_CSR_MAJORELINK(0) | DMA_CSR_BWC(3) | DMA_CSR_INTHALF(1) | DMA_CSR_INTMAJOR(1) | DMA_CSR_DREQ(0);
+    DMAMUX_CHCFG(0) = DMAMUX_CHCFG_ENBL(1)|DMAMUX_CHCFG_TRIG(1)|DMAMUX_CHCFG_SOURCE(60);
+    NVIC_EnableIRQ(0);
+    DMA_SERQ = DMA_SERQ_SERQ(0);
+
+}
+/********************************************************************
+* DMADAC0Init - Initializes DAC0
+*
+* Description:  Enables DAC system, software trigger, and VDDA reference. Also
+*               enables DMA and DAC buffer.
+*
+* Return value: None
+*
+* Arguments:    None
+********************************************************************/
+void DMADAC0Init(void){
+    SIM_SCGC2 = (SIM_SCGC2 | SIM_SCGC2_DAC0(1));
+    DAC0_C0 |= DAC_C0_DACEN(1) | DAC_C0_DACRFS(0) | DAC_C0_DACTRGSEL(1);
+    DAC0_C1 |= (DAC_C1_DMAEN(1) | DAC_C1_DACBFEN(1));
+    VREF_SC = VREF_SC_VREFEN(1)| VREF_SC_MODE_LV(1);
+}
+/********************************************************************
+* DMAPIT0Init - Initializes PIT0
+*
+* Description:  Enables PIT clock 0. Enables all standard timers. Enables
+*               PIT0 timer and PIT0 timer interrupt. Triggers at 300Hz.
+*
+* Return value: None
+*
+* Arguments:    None
+********************************************************************/
+void DMAPIT0Init(void){
+    SIM_SCGC6 = (SIM_SCGC6 | SIM_SCGC6_PIT(1));
+    PIT_MCR = PIT_MCR_MDIS(0);
+    PIT_TCTRL0 = (PIT_TCTRL0 | PIT_TCTRL_TIE(1) | PIT_TCTRL_TEN(1));
+    PIT_LDVAL0 = PIT0_TIMER_VALUE;
+}
+
+void DMA0_DMA16_IRQHandler(void){
+    OS_ERR os_err;
+
+#if (APP_CFG_DMA_LAT_EN == DEF_ENABLED)
+    dmaLatRecord();                             //First, so only entry latency is counted
+#endif
+    OSIntEnter();
+    DMA_CINT = DMA_CINT_CINT(0);
+    if(dmaBufferRdyIndex == 1){
+        dmaBufferRdyIndex = 0;
+    } else{
+        dmaBufferRdyIndex = 1;
+    }
+    if(dmaNotifyGrp != (OS_FLAG_GRP *)0){
+        (void)OSFlagPost(dmaNotifyGrp, dmaNotifyFlag, OS_OPT_POST_FLAG_SET, &os_err);
+    } else{
+        (void)OSSemPost(&dmaBufferDoneFlag, OS_OPT_POST_1, &os_err);
+    }
+    while(os_err != OS_ERR_NONE){}
+
+    OSIntExit();
+}
+
+INT8U DMABlockDonePend(OS_ERR *os_err){
+    (void)OSSemPend(&dmaBufferDoneFlag,0,OS_OPT_PEND_BLOCKING,(CPU_TS *)0, os_err);
+    return dmaBufferRdyIndex;
+}
+
+/********************************************************************
+* DMANotify - Sets flag in grp at each block done instead of posting
+*             the semaphore DMABlockDonePend() waits on
+********************************************************************/
+void DMANotify(OS_FLAG_GRP *grp, OS_FLAGS flag){
+    CPU_SR_ALLOC();
+
+    CPU_CRITICAL_ENTER();                       //The ISR sees both or neither
+    dmaNotifyFlag = flag;
+    dmaNotifyGrp = grp;
+    CPU_CRITICAL_EXIT();
+}
+
+/********************************************************************
+* DMABlockReady - Block of wavCurSamples[] the DMA finished last
+********************************************************************/
+INT8U DMABlockReady(void){
+    return dmaBufferRdyIndex;
+}
+
+/********************************************************************
+* DMANextSample - Index of the next sample the DMA outputs
+*
+* Description:  CITER counts the transfers left before the major loop
+*               reloads, so the next sample out is 128 - CITER. CITER
+*               reads 128 again after the reload, index 0.
+********************************************************************/
+INT8U DMANextSample(void){
+    INT32U citer = DMA_TCD0_CITER_ELINKNO & DMA_CITER_ELINKNO_CITER_MASK;
+    return (INT8U)(((DMA_TWOBLOCKS*DMA_64SAMPLES_PERBLOCK) - citer) & ((DMA_TWOBLOCKS*DMA_64SAMPLES_PERBLOCK) - 1));
+}
+
+/********************************************************************
+* DMALatencyReset - Empties the interrupt latency histogram
+********************************************************************/
+void DMALatencyReset(void){
+#if (APP_CFG_DMA_LAT_EN == DEF_ENABLED)
+    INT8U bin;
+    CPU_SR_ALLOC();
+
+    CPU_CRITICAL_ENTER();
+    for(bin = 0; bin < DMA_LAT_NUM_BINS; bin++){
+        dmaLatHist[bin] = 0;
+    }
+    dmaLatCnt = 0;
+    dmaLatMax = 0;
+    CPU_CRITICAL_EXIT();
+#endif
+}
+
+/********************************************************************
+* DMALatencyPercentile - Latency below which percent of the
+*                        DMA0_DMA16_IRQHandler() entries fell
+*
+* Description:  Walks the bins until the running count reaches percent
+*               of the total. The count is read once first so bins the
+*               ISR adds to during the walk can only make the result
+*               slightly pessimistic.
+********************************************************************/
+INT32U DMALatencyPercentile(INT8U percent){
+    INT32U latency = 0;
+#if (APP_CFG_DMA_LAT_EN == DEF_ENABLED)
+    INT32U target;
+    INT32U running = 0;
+    INT8U bin;
+
+    if(percent > 100){
+        percent = 100;
+    }else{}
+    //Round up so 100 means all, split so the product cannot overflow
+    target = ((dmaLatCnt / 100) * percent) + ((((dmaLatCnt % 100) * percent) + 99) / 100);
+    if(target > 0){
+        for(bin = 0; (bin < DMA_LAT_NUM_BINS) && (running < target); bin++){
+            running += dmaLatHist[bin];
+        }
+        if((running < target) || (bin >= DMA_LAT_NUM_BINS)){
+            latency = dmaLatMax;
+        }else{
+            latency = (INT32U)bin * DMA_LAT_BIN_CYCLES;
+        }
+    }else{}
+#else
+    (void)percent;
+#endif
+    return latency;
+}
+
+/********************************************************************
+* DMALatencyGet - Raw histogram, count and maximum
+********************************************************************/
+const INT32U *DMALatencyGet(INT32U *count, INT32U *max){
+#if (APP_CFG_DMA_LAT_EN == DEF_ENABLED)
+    *count = dmaLatCnt;
+    *max = dmaLatMax;
+    return dmaLatHist;
+#else
+    *count = 0;
+    *max = 0;
+    return (const INT32U *)0;
+#endif
+}
+
+#if (APP_CFG_DMA_LAT_EN == DEF_ENABLED)
+/********************************************************************
+* dmaLatRecord - Adds the current interrupt's entry latency to the
+*                histogram
+*
+* Description:  The half event fires when CITER reaches 64 and the
+*               major event when it reloads to 128, so CITER tells
+*               which event is being serviced and how many PIT0 periods
+*               have passed since. PIT_CVAL0 counts down from LDVAL
+*               and the DMA request is made when it reloads, so
+*               LDVAL - CVAL is the time into the current period:
+*
+*               latency = (expected - CITER)*(LDVAL+1) + (LDVAL - CVAL)
+*
+*               CITER is read on both sides of CVAL so a transfer
+*               between the two reads doesn't add or lose a period.
+*               Only valid while latency is under 64 periods (1.3ms).
+*
+*               Latencies over DMA_LAT_TRACE_LIMIT are written to the
+*               trace buffer when APP_CFG_TRACE_EN is enabled, so the
+*               records just before show what held interrupts off.
+********************************************************************/
+static void dmaLatRecord(void){
+    INT32U citer;
+    INT32U cval;
+    INT32U expected;
+    INT32U latency;
+    INT32U bin;
+
+    do{
+        citer = DMA_TCD0_CITER_ELINKNO & DMA_CITER_ELINKNO_CITER_MASK;
+        cval = PIT_CVAL0;
+    }while(citer != (DMA_TCD0_CITER_ELINKNO & DMA_CITER_ELINKNO_CITER_MASK));
+
+    if(citer > DMA_64SAMPLES_PERBLOCK){         //After the major event reload
+        expected = DMA_TWOBLOCKS*DMA_64SAMPLES_PERBLOCK;
+    }else{                                      //After the half event
+        expected = DMA_64SAMPLES_PERBLOCK;
+    }
+    latency = ((expected - citer) * (PIT0_TIMER_VALUE + 1)) + (PIT0_TIMER_VALUE - cval);
+
+    bin = latency / DMA_LAT_BIN_CYCLES;
+    if(bin >= DMA_LAT_NUM_BINS){
+        bin = DMA_LAT_NUM_BINS - 1;
+    }else{}
+    dmaLatHist[bin]++;
+    dmaLatCnt++;
+    if(latency > dmaLatMax){
+        dmaLatMax = latency;
+    }else{}
+
+#if (APP_CFG_TRACE_EN == DEF_ENABLED)
+    if(latency > DMA_LAT_TRACE_LIMIT){
+        TraceEvent(TRACE_ID_DMA_LATE, (INT8U)(expected - citer), (INT16U)latency);
+    }else{}
+#endif
+}
+#endif
@@ -1,57 +1,131 @@
-/*******************************************************************************
-* DMA.h -   Project header file for DMA.c
-*
-* Created on: Dec 7, 2017
-* Author: Anthony Needles
-*******************************************************************************/
-#ifndef SOURCES_DMA_H_
-#define SOURCES_DMA_H_
-
-#define PIT0_TIMER_VALUE 1250
-#define DMA_16BIT_SAMPLES 1
-#define DMA_2BYTES_PERSAMPLE 2
-#define DMA_64SAMPLES_PERBLOCK 64
-#define DMA_256BYTES_PERBUFFER 256
-#define DMA_TWOBLOCKS 2
-
-extern INT16U wavCurSamples[DMA_TWOBLOCKS][DMA_64SAMPLES_PERBLOCK];
-
-/********************************************************************
-* DMAInit - Initializes DMA0
-*
-* Description:  Enables DMA for use with transferring data in dmaWaveTable to
-*               DAC0. Uses PIT0 for triggering.
-*
-* Return value: None
-*
-* Arguments:    None
-********************************************************************/
-void DMAInit(INT16U *out_block);
-/********************************************************************
-* DMADAC0Init - Initializes DAC0
-*
-* Description:  Enables both DAC0 clocks. Enables DAC system, software trigger,
-*               and VDDA reference. Also enables DMA and DAC buffer.
-*
-* Return value: None
-*
-* Arguments:    None
-********************************************************************/
-void DMADAC0Init(void);
-/********************************************************************
-* DMAPIT0Init - Initializes PIT0
-*
-* Description:  Enables PIT clock. Enables all standard timers. Enables
-*               PIT0 timer and PIT0 timer interrupt. Triggers at 300Hz.
-*
-* Return value: None
-*
-* Arguments:    None
-********************************************************************/
-void DMAPIT0Init(void);
-
-void DMA0_DMA16_IRQHandler(void);
-
-INT8U DMABlockDonePend(OS_ERR *os_err);
-
-#endif /* SOURCES_DMAV1_H_ */
+/*******************************************************************************
+* DMA.h -   Project header file for DMA.c
+*
+* Created on: Dec 7, 2017
+* Author: Anthony Needles
+*******************************************************************************/
+#ifndef SOURCES_DMA_H_
+#define SOURCES_DMA_H_
+
+#define PIT0_TIMER_VALUE 1250
+#define DMA_16BIT_SAMPLES 1
+#define DMA_2BYTES_PERSAMPLE 2
+#define DMA_64SAMPLES_PERBLOCK 64
+#define DMA_256BYTES_PERBUFFER 256
+#define DMA_TWOBLOCKS 2
+
+// Interrupt latency histogram, APP_CFG_DMA_LAT_EN in app_cfg.h
+#define DMA_LAT_NUM_BINS 64             //Last bin also holds everything longer
+#define DMA_LAT_BIN_CYCLES 60           //Bus cycles per bin, 1us at 60MHz
+#define DMA_LAT_TRACE_LIMIT 600         //Bus cycles, longer ones are traced
+
+extern INT16U wavCurSamples[DMA_TWOBLOCKS][DMA_64SAMPLES_PERBLOCK];
+
+/********************************************************************
+* DMAInit - Initializes DMA0
+*
+* Description:  Enables DMA for use with transferring data in dmaWaveTable to
+*               DAC0. Uses PIT0 for triggering.
+*
+* Return value: None
+*
+* Arguments:    None
+********************************************************************/
+void DMAInit(INT16U *out_block);
+/********************************************************************
+* DMADAC0Init - Initializes DAC0
+*
+* Description:  Enables both DAC0 clocks. Enables DAC system, software trigger,
+*               and VDDA reference. Also enables DMA and DAC buffer.
+*
+* Return value: None
+*
+* Arguments:    None
+********************************************************************/
+void DMADAC0Init(void);
+/********************************************************************
+* DMAPIT0Init - Initializes PIT0
+*
+* Description:  Enables PIT clock. Enables all standard timers. Enables
+*               PIT0 timer and PIT0 timer interrupt. Triggers at 300Hz.
+*
+* Return value: None
+*
+* Arguments:    None
+********************************************************************/
+void DMAPIT0Init(void);
+
+void DMA0_DMA16_IRQHandler(void);
+
+INT8U DMABlockDonePend(OS_ERR *os_err);
+
+/********************************************************************
+* DMANotify - Sets flag in grp at each block done instead of posting
+*             the semaphore DMABlockDonePend() waits on
+*
+* Description:  For a task that waits on block done and other events
+*               together. It then reads the block with DMABlockReady().
+*
+* Return value: None
+*
+* Arguments:    grp  - Event flag group to post to
+*               flag - Flag to set in it
+********************************************************************/
+void DMANotify(OS_FLAG_GRP *grp, OS_FLAGS flag);
+
+/********************************************************************
+* DMABlockReady - Block of wavCurSamples[] the DMA finished last, the
+*                 one to fill next. It plays after the other one.
+********************************************************************/
+INT8U DMABlockReady(void);
+
+/********************************************************************
+* DMANextSample - Index into wavCurSamples[][] (as one 128 sample
+*                 buffer) of the next sample the DMA outputs, from the
+*                 live CITER
+*
+* Description:  Samples from this index on have not been output yet.
+*               Block 0 is playing below DMA_64SAMPLES_PERBLOCK, block
+*               1 from there up.
+*
+* Return value: 0 to DMA_TWOBLOCKS*DMA_64SAMPLES_PERBLOCK-1
+*
+* Arguments:    None
+********************************************************************/
+INT8U DMANextSample(void);
+
+/********************************************************************
+* DMALatencyReset - Empties the interrupt latency histogram
+*
+* Return value: None
+*
+* Arguments:    None
+********************************************************************/
+void DMALatencyReset(void);
+
+/********************************************************************
+* DMALatencyPercentile - Latency below which percent of the
+*                        DMA0_DMA16_IRQHandler() entries fell
+*
+* Description:  Latency is bus cycles from the DMA half/major event to
+*               the first instruction of the handler. The result is
+*               the upper edge of the bin the percentile falls in, or
+*               the measured maximum if that is in the last bin.
+*
+* Return value: Latency in bus cycles, 0 if nothing recorded yet
+*
+* Arguments:    percent - 1 to 100, e.g. 50, 99, 100 for the maximum
+********************************************************************/
+INT32U DMALatencyPercentile(INT8U percent);
+
+/********************************************************************
+* DMALatencyGet - Raw histogram, count and maximum
+*
+* Return value: Pointer to the DMA_LAT_NUM_BINS bin counts
+*
+* Arguments:    count - Destination of the number of interrupts recorded
+*               max   - Destination of the longest latency in bus cycles
+********************************************************************/
+const INT32U *DMALatencyGet(INT32U *count, INT32U *max);
+
+#endif /* SOURCES_DMAV1_H_ */
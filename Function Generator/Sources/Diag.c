@@ -0,0 +1,235 @@
+/*******************************************************************************
+* Diag.c - Task diagnostics. Reads the profile fields uC/OS-III keeps in every
+*          OS_TCB (CPUUsage, CtxSwCtr, StkFree/StkUsed) from the statistic
+*          task hook, turns the context switch counters into rates and shows
+*          the result on DIAG_LAYER, hidden until toggled with the 'C' key.
+*
+*          Enabled with APP_CFG_DIAG_EN in app_cfg.h, which also turns on
+*          OS_CFG_DBG_EN for the kernel task list and the per-task load.
+*          That costs every kernel object its debug name and list links,
+*          a few hundred bytes of RAM here, and the kernel code that keeps
+*          them. OS_CFG_TASK_PROFILE_EN/OS_CFG_STAT_TASK_STK_CHK_EN supply
+*          the fields themselves, see os_cfg.h.
+*
+*          The stat task computes the per-task loads after calling its hook,
+*          so the loads and stack figures lag the totals by one stat period.
+*
+* Display, refreshed once a second (no spaces, they are transparent):
+*   row 1  CPU:45.6%:S:1234   total load, context switches per second
+*   row 2  P03:12.3%:F:045w   one task per refresh: prio, load, stack free
+*******************************************************************************/
+#include "MCUType.h"
+#include "app_cfg.h"
+#include "os.h"
+#include "LcdLayered.h"
+#include "Diag.h"
+#include "Fmt.h"
+
+#if (APP_CFG_DIAG_EN == DEF_ENABLED)
+
+#define DIAG_ROW_LEN 16
+
+/*****************************************************************************************
+* Task
+*****************************************************************************************/
+static OS_TCB diagTaskTCB;
+static CPU_STK diagTaskStk[APP_CFG_DIAG_TASK_STK_SIZE];
+static void diagTask(void *p_arg);
+
+/*****************************************************************************************
+* Private resources
+*****************************************************************************************/
+static DIAG_TASK diagTasks[DIAG_MAX_TASKS];
+static OS_CTX_SW_CTR diagPrevCtxSw[DIAG_MAX_TASKS];
+static OS_CTX_SW_CTR diagPrevTotalCtxSw;
+static INT8U diagTaskCount;
+static INT16U diagCPUUsage;
+static INT32U diagCtxSwPerSec;
+static INT8U diagSampleCnt;
+static INT8U diagDispIndex;
+
+static void diagFmtLoad(INT8C *dest, INT16U load);
+
+/********************************************************************
+* DiagInit - Creates the diagnostics display task
+********************************************************************/
+void DiagInit(void){
+    OS_ERR os_err;
+
+    LcdHideLayer(DIAG_LAYER);
+
+    OSTaskCreate(&diagTaskTCB,
+                 "Diag Task",
+                 diagTask,
+                 (void *) 0,
+                 APP_CFG_DIAG_TASK_PRIO,
+                 &diagTaskStk[0],
+                 (APP_CFG_DIAG_TASK_STK_SIZE / 10u),
+                 APP_CFG_DIAG_TASK_STK_SIZE,
+                 0,
+                 0,
+                 (void *) 0,
+                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR),
+                 &os_err);
+    while(os_err != OS_ERR_NONE){}              //Error Trap
+}
+
+/********************************************************************
+* DiagSample - Samples the task profile fields of every task
+*
+* Description:  Each task's entry is built locally and copied in a
+*               critical section so DiagTaskGet() never sees half an
+*               update. A task is matched to its entry by TCB address;
+*               when a new task shifts the list the moved entries
+*               restart their rate at the next sample.
+********************************************************************/
+void DiagSample(void){
+    OS_TCB *p_tcb;
+    OS_CTX_SW_CTR ctxsw;
+    DIAG_TASK sample;
+    INT8U cnt = 0;
+    OS_ERR os_err;
+    CPU_SR_ALLOC();
+
+    CPU_CRITICAL_ENTER();
+    p_tcb = OSTaskDbgListPtr;
+    ctxsw = OSTaskCtxSwCtr;
+    diagCPUUsage = OSStatTaskCPUUsage;
+    diagCtxSwPerSec = (INT32U)(ctxsw - diagPrevTotalCtxSw) * OSCfg_StatTaskRate_Hz;
+    CPU_CRITICAL_EXIT();
+    diagPrevTotalCtxSw = ctxsw;
+
+    while((p_tcb != (OS_TCB *)0) && (cnt < DIAG_MAX_TASKS)){
+        ctxsw = p_tcb->CtxSwCtr;
+        if(diagTasks[cnt].tcb != p_tcb){        //New task at this index
+            diagPrevCtxSw[cnt] = ctxsw;
+        }else{}
+        sample.tcb = p_tcb;
+        sample.name = p_tcb->NamePtr;
+        sample.prio = p_tcb->Prio;
+        sample.load = p_tcb->CPUUsage;
+        sample.load_max = p_tcb->CPUUsageMax;
+        sample.ctxsw_per_sec = (INT32U)(ctxsw - diagPrevCtxSw[cnt]) * OSCfg_StatTaskRate_Hz;
+        sample.stk_free = p_tcb->StkFree;
+        sample.stk_used = p_tcb->StkUsed;
+        diagPrevCtxSw[cnt] = ctxsw;
+
+        CPU_CRITICAL_ENTER();
+        diagTasks[cnt] = sample;
+        p_tcb = p_tcb->DbgNextPtr;
+        CPU_CRITICAL_EXIT();
+        cnt++;
+    }
+    diagTaskCount = cnt;
+
+    diagSampleCnt++;
+    if(diagSampleCnt >= OSCfg_StatTaskRate_Hz){ //Refresh the display once a second
+        diagSampleCnt = 0;
+        (void)OSTaskSemPost(&diagTaskTCB, OS_OPT_POST_NONE, &os_err);
+    }else{}
+}
+
+/********************************************************************
+* DiagTaskCnt - Returns the number of tasks in the last sample
+********************************************************************/
+INT8U DiagTaskCnt(void){
+    return diagTaskCount;
+}
+
+/********************************************************************
+* DiagTaskGet - Copies one task's figures from the last sample
+********************************************************************/
+INT8U DiagTaskGet(INT8U index, DIAG_TASK *task){
+    INT8U valid = FALSE;
+    CPU_SR_ALLOC();
+
+    if(index < diagTaskCount){
+        CPU_CRITICAL_ENTER();
+        *task = diagTasks[index];
+        CPU_CRITICAL_EXIT();
+        valid = TRUE;
+    }else{}
+    return valid;
+}
+
+/********************************************************************
+* DiagCPUUsage - Total CPU load from the last sample, 0.01% units
+********************************************************************/
+INT16U DiagCPUUsage(void){
+    return diagCPUUsage;
+}
+
+/********************************************************************
+* DiagCtxSwPerSec - Total context switches per second, last sample
+********************************************************************/
+INT32U DiagCtxSwPerSec(void){
+    return diagCtxSwPerSec;
+}
+
+/********************************************************************
+* diagTask - Redraws DIAG_LAYER when DiagSample() posts, once a second
+*
+* Description:  The layer is drawn whether it is shown or hidden, the
+*               LCD task only writes characters that actually change
+*               on the display.
+********************************************************************/
+static void diagTask(void *p_arg){
+    OS_ERR os_err;
+    DIAG_TASK task;
+    INT8C row[DIAG_ROW_LEN+1];
+    (void)p_arg;
+
+    row[DIAG_ROW_LEN] = 0;
+    while(1){
+        (void)OSTaskSemPend(0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
+        while(os_err != OS_ERR_NONE){}          //Error Trap
+
+        LcdBegin();
+        //"CPU:45.6%:S:1234"
+        row[0] = 'C';
+        row[1] = 'P';
+        row[2] = 'U';
+        row[3] = ':';
+        diagFmtLoad(&row[4], DiagCPUUsage());
+        row[9] = ':';
+        row[10] = 'S';
+        row[11] = ':';
+        (void)FmtDec(&row[12], DiagCtxSwPerSec(), 4);
+        LcdDispString(1, 1, DIAG_LAYER, row);
+
+        //"P03:12.3%:F:045w", next task each refresh
+        if(diagDispIndex >= DiagTaskCnt()){
+            diagDispIndex = 0;
+        }else{}
+        if(DiagTaskGet(diagDispIndex, &task) == TRUE){
+            row[0] = 'P';
+            (void)FmtDec(&row[1], task.prio, 2);
+            row[3] = ':';
+            diagFmtLoad(&row[4], task.load);
+            row[9] = ':';
+            row[10] = 'F';
+            row[11] = ':';
+            (void)FmtDec(&row[12], task.stk_free, 3);
+            row[15] = 'w';
+            LcdDispString(2, 1, DIAG_LAYER, row);
+        }else{}
+        (void)LcdCommit();
+        diagDispIndex++;
+    }
+}
+
+/********************************************************************
+* diagFmtLoad - Writes a 0.01% load as "45.6%", five characters,
+*               100% shows as 99.9%
+********************************************************************/
+static void diagFmtLoad(INT8C *dest, INT16U load){
+    (void)FmtDec(&dest[0], (INT32U)load / 100, 2);
+    dest[2] = '.';
+    (void)FmtDec(&dest[3], ((INT32U)load / 10) % 10, 1);
+    if(load >= 10000){
+        dest[3] = '9';
+    }else{}
+    dest[4] = '%';
+}
+
+#endif /* APP_CFG_DIAG_EN */
@@ -0,0 +1,74 @@
+/*******************************************************************************
+* Diag.h - Project header file for Diag.c
+*
+* Loads are in units of 0.01%, the same as OSStatTaskCPUUsage and the
+* OS_TCB CPUUsage field. Stack figures are in CPU_STK elements (words).
+*******************************************************************************/
+#ifndef SOURCES_DIAG_H_
+#define SOURCES_DIAG_H_
+
+#define DIAG_MAX_TASKS 12               //Tasks tracked, the rest are ignored
+
+typedef struct{
+    OS_TCB *tcb;
+    const CPU_CHAR *name;
+    OS_PRIO prio;
+    INT16U load;                        //Share of the CPU over the last stat period
+    INT16U load_max;
+    INT32U ctxsw_per_sec;               //Times the task was switched in per second
+    INT32U stk_free;                    //Stack never used since the task started
+    INT32U stk_used;
+} DIAG_TASK;
+
+/********************************************************************
+* DiagInit - Creates the diagnostics display task
+*
+* Description:  Call after LcdInit(). Sampling starts once the stat
+*               hook is installed with App_OS_SetAllHooks().
+*
+* Return value: None
+*
+* Arguments:    None
+********************************************************************/
+void DiagInit(void);
+
+/********************************************************************
+* DiagSample - Samples the task profile fields of every task
+*
+* Description:  Called by App_OS_StatTaskHook() from the statistic
+*               task, OS_CFG_STAT_TASK_RATE_HZ times a second. Must not
+*               be called from anywhere else since the context switch
+*               rates assume that period.
+*
+* Return value: None
+*
+* Arguments:    None
+********************************************************************/
+void DiagSample(void);
+
+/********************************************************************
+* DiagTaskCnt - Returns the number of tasks in the last sample
+********************************************************************/
+INT8U DiagTaskCnt(void);
+
+/********************************************************************
+* DiagTaskGet - Copies one task's figures from the last sample
+*
+* Return value: TRUE if index was valid, else FALSE
+*
+* Arguments:    index - 0 to DiagTaskCnt()-1
+*               task  - Destination of the copy
+********************************************************************/
+INT8U DiagTaskGet(INT8U index, DIAG_TASK *task);
+
+/********************************************************************
+* DiagCPUUsage - Total CPU load from the last sample, 0.01% units
+********************************************************************/
+INT16U DiagCPUUsage(void);
+
+/********************************************************************
+* DiagCtxSwPerSec - Total context switches per second, last sample
+********************************************************************/
+INT32U DiagCtxSwPerSec(void);
+
+#endif /* SOURCES_DIAG_H_ */
@@ -0,0 +1,39 @@
+/*******************************************************************************
+* Fmt.c - Decimal formatting without division, see Fmt.h
+*******************************************************************************/
+#include "MCUType.h"
+#include "Fmt.h"
+
+static const INT32U fmtPow10[FMT_MAX_DIGITS] = {1000000000, 100000000, 10000000,
+    1000000, 100000, 10000, 1000, 100, 10, 1};
+
+/********************************************************************
+* FmtDec - Writes value as decimal characters. fmtPow10[FMT_MAX_DIGITS-1-n]
+*          is 10^n, the smallest value that does not fit in n digits.
+********************************************************************/
+INT8U FmtDec(INT8C *dest, INT32U value, INT8U digits){
+    INT8U i;
+    INT8U len = 0;
+    INT8C c;
+
+    if(digits == 0){
+        digits = 1;
+        while((digits < FMT_MAX_DIGITS) && (value >= fmtPow10[FMT_MAX_DIGITS - 1 - digits])){
+            digits++;
+        }
+    } else if(digits >= FMT_MAX_DIGITS){
+        digits = FMT_MAX_DIGITS;
+    } else if(value >= fmtPow10[FMT_MAX_DIGITS - 1 - digits]){
+        value = fmtPow10[FMT_MAX_DIGITS - 1 - digits] - 1;
+    } else{}
+    for(i = FMT_MAX_DIGITS - digits; i < FMT_MAX_DIGITS; i++){
+        c = '0';
+        while(value >= fmtPow10[i]){
+            value -= fmtPow10[i];
+            c++;
+        }
+        dest[len] = c;
+        len++;
+    }
+    return len;
+}
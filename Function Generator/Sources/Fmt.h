@@ -0,0 +1,28 @@
+/*******************************************************************************
+* Fmt.h - Project header file for Fmt.c, decimal formatting shared by the
+*         LCD layers and the serial replies
+*******************************************************************************/
+#ifndef SOURCES_FMT_H_
+#define SOURCES_FMT_H_
+
+#define FMT_MAX_DIGITS 10               //Enough for any INT32U
+
+/********************************************************************
+* FmtDec - Writes value as decimal characters
+*
+* Description:  No division, each digit is counted by subtracting its
+*               power of ten, at most 9 times. No terminator is
+*               written.
+*
+* Return value: Number of characters written
+*
+* Arguments:    dest   - Destination, at least digits characters, or
+*                        FMT_MAX_DIGITS if digits is 0
+*               value  - Value to write
+*               digits - 1 to FMT_MAX_DIGITS for exactly that many
+*                        characters, zero filled, all 9s if value does
+*                        not fit. 0 for as many as value needs.
+********************************************************************/
+INT8U FmtDec(INT8C *dest, INT32U value, INT8U digits);
+
+#endif /* SOURCES_FMT_H_ */
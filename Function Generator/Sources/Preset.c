@@ -0,0 +1,239 @@
+/*******************************************************************************
+* Preset.c - Wave presets in program flash, written as a log so the sectors
+*            wear evenly instead of erasing one for every save.
+*
+*            Each sector starts with a header phrase {PRESET_MAGIC, generation}
+*            followed by one 8 byte record phrase per save. The sector with a
+*            valid header and the highest generation is the active one and the
+*            last record for a slot in it wins. Erased phrases read all 0xFF,
+*            so the log ends at the first record with slot 0xFF.
+*
+*            When the active sector is full the newest record of every slot is
+*            copied into the other sector after erasing it, and its header is
+*            written last. A reset part way through leaves the old sector
+*            active, and a record cut short fails its check byte and is
+*            skipped.
+*
+*            All presets are cached in RAM, so recall never reads flash.
+*******************************************************************************/
+#include "MCUType.h"
+#include "app_cfg.h"
+#include "os.h"
+#include "Wave.h"
+#include "Flash.h"
+#include "Preset.h"
+
+#define PRESET_MAGIC 0x54535250U        //"PRST"
+#define PRESET_RECS_PER_SECTOR ((FLASH_SECTOR_SIZE/FLASH_PHRASE_SIZE) - 1)
+#define PRESET_NO_SECTOR 0xFFU
+
+typedef struct{
+    INT32U magic;
+    INT32U gen;
+} PRESET_HDR;
+
+typedef struct{
+    INT16U freq;
+    INT8U amp;
+    INT8U shape;
+    INT8U slot;                         //0xFF if erased
+    INT8U rsvd0;
+    INT8U rsvd1;
+    INT8U check;                        //~sum of the bytes before it
+} PRESET_REC;
+
+static OS_MUTEX presetKey;
+static WAVE_W presetWaves[PRESET_SLOTS];
+static INT16U presetValid;              //Bit per slot
+static INT8U presetSector = PRESET_NO_SECTOR;   //Active sector
+static INT32U presetGen;
+static INT16U presetNext;               //Next free record in the active sector
+
+static const PRESET_HDR *presetHdr(INT8U sector);
+static const PRESET_REC *presetRecs(INT8U sector);
+static INT8U presetCheck(const PRESET_REC *rec);
+static INT8U presetStart(INT8U sector, INT32U gen, INT8U erase);
+static INT8U presetWrite(INT8U slot, const WAVE_W *wave);
+
+/********************************************************************
+* PresetInit - Picks the active sector and replays its log into RAM
+********************************************************************/
+void PresetInit(void){
+    OS_ERR os_err;
+    const PRESET_HDR *hdr;
+    const PRESET_REC *rec;
+    INT8U sector;
+    INT16U i;
+
+    OSMutexCreate(&presetKey, "Preset Key", &os_err);
+    while(os_err != OS_ERR_NONE){}          //Error Trap
+
+    for(sector = 0; sector < PRESET_SECTORS; sector++){
+        hdr = presetHdr(sector);
+        if((hdr->magic == PRESET_MAGIC) &&
+           ((presetSector == PRESET_NO_SECTOR) || (hdr->gen > presetGen))){
+            presetSector = sector;
+            presetGen = hdr->gen;
+        }else{}
+    }
+
+    presetValid = 0;
+    presetNext = 0;
+    if(presetSector != PRESET_NO_SECTOR){
+        rec = presetRecs(presetSector);
+        for(i = 0; (i < PRESET_RECS_PER_SECTOR) && (rec[i].slot != 0xFFU); i++){
+            if((rec[i].slot < PRESET_SLOTS) && (rec[i].check == presetCheck(&rec[i]))){
+                presetWaves[rec[i].slot].freq = rec[i].freq;
+                presetWaves[rec[i].slot].amp = rec[i].amp;
+                presetWaves[rec[i].slot].waveshape = (WAVE_TYPE)rec[i].shape;
+                presetValid |= (INT16U)(1U << rec[i].slot);
+            }else{}                         //Cut short, the phrase stays used
+        }
+        presetNext = i;
+    }else{}
+}
+
+/********************************************************************
+* PresetGet - Copies a preset from RAM
+********************************************************************/
+INT8U PresetGet(INT8U slot, WAVE_W *wave){
+    OS_ERR os_err;
+    INT8U valid = FALSE;
+
+    OSMutexPend(&presetKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
+    while(os_err != OS_ERR_NONE){}          //Error Trap
+    if((slot < PRESET_SLOTS) && ((presetValid & (1U << slot)) != 0)){
+        *wave = presetWaves[slot];
+        valid = TRUE;
+    }else{}
+    OSMutexPost(&presetKey, OS_OPT_POST_NONE, &os_err);
+    while(os_err != OS_ERR_NONE){}          //Error Trap
+    return valid;
+}
+
+/********************************************************************
+* PresetSave - Saves wave in slot
+*
+* Description:  The first save formats sector 0. A full sector is
+*               compacted into the other one with the new record
+*               already in the RAM copy, so it is written there. On a
+*               flash error the RAM copy keeps the new settings for
+*               this session only.
+********************************************************************/
+INT8U PresetSave(INT8U slot, const WAVE_W *wave){
+    OS_ERR os_err;
+    INT8U ok = FALSE;
+    INT8U old;
+    INT8U i;
+
+    if(slot < PRESET_SLOTS){
+        OSMutexPend(&presetKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
+        while(os_err != OS_ERR_NONE){}      //Error Trap
+
+        if(((presetValid & (1U << slot)) != 0) &&
+           (presetWaves[slot].freq == wave->freq) && (presetWaves[slot].amp == wave->amp) &&
+           (presetWaves[slot].waveshape == wave->waveshape)){
+            ok = TRUE;                      //Already saved
+        }else{
+            presetWaves[slot] = *wave;
+            presetValid |= (INT16U)(1U << slot);
+            if(presetSector == PRESET_NO_SECTOR){
+                ok = presetStart(0, 1, TRUE);
+                if(ok == TRUE){
+                    ok = presetWrite(slot, wave);
+                }else{}
+            }else if(presetNext < PRESET_RECS_PER_SECTOR){
+                ok = presetWrite(slot, wave);
+            }else{                          //Full, compact into the other sector
+                old = presetSector;
+                ok = FlashEraseSector(PRESET_FLASH_ADDR + ((INT32U)(old ^ 1U)*FLASH_SECTOR_SIZE));
+                presetSector = old ^ 1U;
+                presetNext = 0;
+                for(i = 0; (i < PRESET_SLOTS) && (ok == TRUE); i++){
+                    if((presetValid & (1U << i)) != 0){
+                        ok = presetWrite(i, &presetWaves[i]);
+                    }else{}
+                }
+                if(ok == TRUE){             //Header last, commits the copy
+                    ok = presetStart(presetSector, presetGen + 1, FALSE);
+                }else{
+                    presetSector = old;     //Old sector stays active
+                    presetNext = PRESET_RECS_PER_SECTOR;
+                }
+            }
+        }
+
+        OSMutexPost(&presetKey, OS_OPT_POST_NONE, &os_err);
+        while(os_err != OS_ERR_NONE){}      //Error Trap
+    }else{}
+    return ok;
+}
+
+/********************************************************************
+* presetHdr/presetRecs - Header and records of a sector, read in place
+********************************************************************/
+static const PRESET_HDR *presetHdr(INT8U sector){
+    return (const PRESET_HDR *)(PRESET_FLASH_ADDR + ((INT32U)sector*FLASH_SECTOR_SIZE));
+}
+
+static const PRESET_REC *presetRecs(INT8U sector){
+    return (const PRESET_REC *)(PRESET_FLASH_ADDR + ((INT32U)sector*FLASH_SECTOR_SIZE) + FLASH_PHRASE_SIZE);
+}
+
+/********************************************************************
+* presetCheck - Check byte of a record, ~sum of its first 7 bytes
+********************************************************************/
+static INT8U presetCheck(const PRESET_REC *rec){
+    const INT8U *bytes = (const INT8U *)rec;
+    INT8U sum = 0;
+    INT8U i;
+
+    for(i = 0; i < (sizeof(PRESET_REC) - 1); i++){
+        sum += bytes[i];
+    }
+    return (INT8U)~sum;
+}
+
+/********************************************************************
+* presetStart - Makes sector the active one with generation gen,
+*               erasing it first if erase is TRUE. Without, it must
+*               have been erased before its records were written.
+********************************************************************/
+static INT8U presetStart(INT8U sector, INT32U gen, INT8U erase){
+    PRESET_HDR hdr;
+    INT8U ok = TRUE;
+
+    if(erase == TRUE){
+        ok = FlashEraseSector(PRESET_FLASH_ADDR + ((INT32U)sector*FLASH_SECTOR_SIZE));
+        presetNext = 0;
+    }else{}
+    if(ok == TRUE){
+        hdr.magic = PRESET_MAGIC;
+        hdr.gen = gen;
+        ok = FlashProgramPhrase((INT32U)presetHdr(sector), (const INT8U *)&hdr);
+    }else{}
+    if(ok == TRUE){
+        presetSector = sector;
+        presetGen = gen;
+    }else{}
+    return ok;
+}
+
+/********************************************************************
+* presetWrite - Appends a record to the active sector
+********************************************************************/
+static INT8U presetWrite(INT8U slot, const WAVE_W *wave){
+    PRESET_REC rec;
+    INT8U ok;
+
+    rec.freq = wave->freq;
+    rec.amp = wave->amp;
+    rec.shape = (INT8U)wave->waveshape;
+    rec.slot = slot;
+    rec.rsvd0 = 0xFFU;
+    rec.rsvd1 = 0xFFU;
+    rec.check = presetCheck(&rec);
+    ok = FlashProgramPhrase((INT32U)&presetRecs(presetSector)[presetNext], (const INT8U *)&rec);
+    presetNext++;                           //Used even if it failed
+    return ok;
+}
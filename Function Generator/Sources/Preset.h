@@ -0,0 +1,52 @@
+/*******************************************************************************
+* Preset.h - Project header file for Preset.c
+*
+* PRESET_SLOTS wave settings kept in program flash across resets. The two
+* sectors from PRESET_FLASH_ADDR are left out of m_text by the linker file.
+*******************************************************************************/
+#ifndef SOURCES_PRESET_H_
+#define SOURCES_PRESET_H_
+
+#define PRESET_SLOTS 10                 //One per digit key
+#define PRESET_FLASH_ADDR 0x001FE000U   //m_presets in the linker file
+#define PRESET_SECTORS 2
+
+/********************************************************************
+* PresetInit - Loads the saved presets from flash
+*
+* Description:  Only reads flash. Call before PresetGet() or
+*               PresetSave(), from a task.
+*
+* Return value: None
+*
+* Arguments:    None
+********************************************************************/
+void PresetInit(void);
+
+/********************************************************************
+* PresetGet - Copies a preset from RAM, no flash access
+*
+* Return value: TRUE if slot has been saved, else FALSE
+*
+* Arguments:    slot - 0 to PRESET_SLOTS-1
+*               wave - Destination of the copy
+********************************************************************/
+INT8U PresetGet(INT8U slot, WAVE_W *wave);
+
+/********************************************************************
+* PresetSave - Saves wave in slot
+*
+* Description:  Appends one record to the flash log, or nothing if
+*               slot already holds wave. About every 500 saves the
+*               log is compacted into the other sector, which takes
+*               an erase of up to ~100ms. Pends on a mutex, so any
+*               task may call it.
+*
+* Return value: TRUE if saved, FALSE on a bad slot or flash error
+*
+* Arguments:    slot - 0 to PRESET_SLOTS-1
+*               wave - Settings to save
+********************************************************************/
+INT8U PresetSave(INT8U slot, const WAVE_W *wave);
+
+#endif /* SOURCES_PRESET_H_ */
@@ -0,0 +1,703 @@
+/*******************************************************************************
+* Scpi.c - SCPI style command interface on the serial port, see Scpi.h for the
+*          commands.
+*
+*          Lines are never copied out of the Serial.c receive ring. The task
+*          finds each line end, then splits the line into commands at ';' and
+*          each command into header nodes and an argument, all as SCPI_TOK
+*          index/length pairs into the ring, so a line wrapping around the
+*          end of the ring needs no special case. Mnemonics and keywords are
+*          compared a character at a time against the table, nothing is
+*          allocated or terminated.
+*
+*          The task polls the ring head every tick while input is coming and
+*          every APP_CFG_SCPI_IDLE_POLL_TICKS once it has been quiet for
+*          SCPI_IDLE_TICKS. A change of the wave is sent with WaveSetLive()
+*          stamped with the poll that found the line, so SYSTem:LATency? is
+*          line to DAC less up to one poll of serial receive time.
+*
+*          Sweep is linear from start to stop, restarting at start, in steps
+*          of APP_CFG_SCPI_SWEEP_STEP_TICKS. FREQuency or PRESet:RECall ends
+*          it.
+*******************************************************************************/
+#include "MCUType.h"
+#include "app_cfg.h"
+#include "os.h"
+#include "CycleCnt.h"
+#include "Serial.h"
+#include "Wave.h"
+#include "Preset.h"
+#include "Scpi.h"
+#include "Fmt.h"
+
+#define SCPI_LINE_MAX 128U              //Longer lines are dropped with -363
+#define SCPI_MAX_NODES 2
+#define SCPI_REPLY_MAX 48U
+#define SCPI_IDLE_TICKS 100U
+#define SCPI_FREQ_MIN 10U
+#define SCPI_FREQ_MAX 10000U
+#define SCPI_SWEEP_MS_MIN 10U
+#define SCPI_SWEEP_MS_MAX 60000U
+
+//Error codes, SCPI-99 standard numbers
+#define SCPI_ERR_NONE 0
+#define SCPI_ERR_SYNTAX (-102)
+#define SCPI_ERR_DATA_TYPE (-104)
+#define SCPI_ERR_MISSING (-109)
+#define SCPI_ERR_HEADER (-113)
+#define SCPI_ERR_EXEC (-200)
+#define SCPI_ERR_RANGE (-222)
+#define SCPI_ERR_ILLEGAL (-224)
+#define SCPI_ERR_OVERRUN (-363)
+
+/*****************************************************************************************
+* Task
+*****************************************************************************************/
+static OS_TCB scpiTaskTCB;
+static CPU_STK scpiTaskStk[APP_CFG_SCPI_TASK_STK_SIZE];
+static void scpiTask(void *p_arg);
+
+/*****************************************************************************************
+* Parsed command, every field is a slice of the receive ring
+*****************************************************************************************/
+typedef struct{
+    INT16U pos;                         //Ring index of the first character, unmasked
+    INT16U len;
+} SCPI_TOK;
+
+typedef struct{
+    SCPI_TOK node[SCPI_MAX_NODES];      //Header mnemonics, '*' kept on a common command
+    INT8U nodes;
+    INT8U query;                        //Header ended with '?'
+    SCPI_TOK arg;                       //len 0 if there is none
+} SCPI_CMD;
+
+//Mnemonics in SCPI notation, the upper case part is the short form
+typedef struct{
+    const INT8C *mnem[SCPI_MAX_NODES];  //Unused levels 0
+    void (*exec)(const SCPI_CMD *cmd);
+} SCPI_ENTRY;
+
+static void scpiIdn(const SCPI_CMD *cmd);
+static void scpiCls(const SCPI_CMD *cmd);
+static void scpiFreq(const SCPI_CMD *cmd);
+static void scpiAmpl(const SCPI_CMD *cmd);
+static void scpiShape(const SCPI_CMD *cmd);
+static void scpiSweepStart(const SCPI_CMD *cmd);
+static void scpiSweepStop(const SCPI_CMD *cmd);
+static void scpiSweepTime(const SCPI_CMD *cmd);
+static void scpiSweepState(const SCPI_CMD *cmd);
+static void scpiPresetSave(const SCPI_CMD *cmd);
+static void scpiPresetRecall(const SCPI_CMD *cmd);
+static void scpiSysError(const SCPI_CMD *cmd);
+static void scpiSysLatency(const SCPI_CMD *cmd);
+static void scpiSysParse(const SCPI_CMD *cmd);
+
+static const SCPI_ENTRY scpiTable[] = {
+    {{"*IDN", 0}, scpiIdn},
+    {{"*CLS", 0}, scpiCls},
+    {{"FREQuency", 0}, scpiFreq},
+    {{"AMPLitude", 0}, scpiAmpl},
+    {{"SHAPe", 0}, scpiShape},
+    {{"SWEep", "STARt"}, scpiSweepStart},
+    {{"SWEep", "STOP"}, scpiSweepStop},
+    {{"SWEep", "TIME"}, scpiSweepTime},
+    {{"SWEep", "STATe"}, scpiSweepState},
+    {{"PRESet", "SAVE"}, scpiPresetSave},
+    {{"PRESet", "RECall"}, scpiPresetRecall},
+    {{"SYSTem", "ERRor"}, scpiSysError},
+    {{"SYSTem", "LATency"}, scpiSysLatency},
+    {{"SYSTem", "PARSe"}, scpiSysParse},
+};
+#define SCPI_TABLE_LEN (sizeof(scpiTable) / sizeof(scpiTable[0]))
+
+/*****************************************************************************************
+* Private resources, scpiTask only
+*****************************************************************************************/
+static const INT8U *scpiRing;
+static INT16U scpiTail;                 //Start of the line being received
+static INT16U scpiScan;                 //Next character to look at for a line end
+static INT8U scpiDrop = FALSE;          //Line too long, skipping to its end
+static OS_TICK scpiLineTime;            //Poll that found the line being run
+static INT16S scpiErr = SCPI_ERR_NONE;
+static INT32U scpiLines;
+static INT32U scpiParseCycles;          //Of the line being run
+static INT32U scpiParseCyclesMax;
+
+static INT16U scpiSweepFrom = SCPI_FREQ_MIN;
+static INT16U scpiSweepTo = SCPI_FREQ_MAX;
+static INT16U scpiSweepMs = 1000;
+static INT8U scpiSweepOn = FALSE;
+static OS_TICK scpiSweepBegin;
+static OS_TICK scpiSweepDue;
+
+static OS_FLAG_GRP *scpiNotifyGrp = (OS_FLAG_GRP *)0;
+static OS_FLAGS scpiNotifyFlag;
+
+static void scpiFindLines(INT16U head);
+static void scpiLine(INT16U pos, INT16U len);
+static void scpiRun(INT16U pos, INT16U len);
+static INT8U scpiSplit(INT16U pos, INT16U len, SCPI_CMD *cmd);
+static INT8U scpiMatch(const SCPI_TOK *tok, const INT8C *mnem);
+static INT8U scpiArgNum(const SCPI_CMD *cmd, INT32U min, INT32U max, INT32U *value);
+static void scpiNumQuery(INT32U value);
+static void scpiSetWave(const WAVE_W *wave);
+static void scpiSweepStep(void);
+static void scpiChanged(void);
+static void scpiError(INT16S err);
+
+#define SCPI_CH(pos) ((INT8C)scpiRing[(pos) & SERIAL_RX_MASK])
+#define SCPI_UPPER(c) ((((c) >= 'a') && ((c) <= 'z')) ? (INT8C)((c) - ('a' - 'A')) : (c))
+#define SCPI_IS_SPACE(c) (((c) == ' ') || ((c) == '\t'))
+#define SCPI_IS_ALNUM(c) ((((c) >= 'A') && ((c) <= 'Z')) || (((c) >= 'a') && ((c) <= 'z')) || \
+                          (((c) >= '0') && ((c) <= '9')))
+
+/********************************************************************
+* ScpiInit - Starts the serial port and creates the command task
+********************************************************************/
+void ScpiInit(void){
+    OS_ERR os_err;
+
+    SerialInit();
+    scpiRing = SerialRxRing();
+    scpiTail = SerialRxHead();
+    scpiScan = scpiTail;
+
+    OSTaskCreate(&scpiTaskTCB,
+                 "SCPI Task",
+                 scpiTask,
+                 (void *) 0,
+                 APP_CFG_SCPI_TASK_PRIO,
+                 &scpiTaskStk[0],
+                 (APP_CFG_SCPI_TASK_STK_SIZE / 10u),
+                 APP_CFG_SCPI_TASK_STK_SIZE,
+                 0,
+                 0,
+                 (void *) 0,
+                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR),
+                 &os_err);
+    while(os_err != OS_ERR_NONE){}              //Error Trap
+}
+
+/********************************************************************
+* ScpiNotify - Sets flag in grp whenever a command changes the wave
+********************************************************************/
+void ScpiNotify(OS_FLAG_GRP *grp, OS_FLAGS flag){
+    scpiNotifyFlag = flag;
+    scpiNotifyGrp = grp;
+}
+
+/********************************************************************
+* scpiTask - Polls the ring for lines and steps the sweep
+********************************************************************/
+static void scpiTask(void *p_arg){
+    OS_ERR os_err;
+    INT16U head;
+    INT16U idle = 0;
+    OS_TICK dly = 1;
+    (void)p_arg;
+
+    while(1){
+        OSTimeDly(dly, OS_OPT_TIME_DLY, &os_err);
+        while(os_err != OS_ERR_NONE){}          //Error Trap
+
+        head = SerialRxHead();
+        if(head != scpiScan){
+            idle = 0;
+            scpiLineTime = OSTimeGet(&os_err);
+            scpiFindLines(head);
+        } else if(idle < SCPI_IDLE_TICKS){
+            idle++;
+        } else{}
+        scpiSweepStep();
+
+        if(idle < SCPI_IDLE_TICKS){
+            dly = 1;
+        } else{
+            dly = APP_CFG_SCPI_IDLE_POLL_TICKS;
+        }
+    }
+}
+
+/********************************************************************
+* scpiFindLines - Runs each line ended before head. An empty line, as
+*                 between the CR and LF of CRLF, is skipped.
+********************************************************************/
+static void scpiFindLines(INT16U head){
+    INT8C c;
+    INT16U len;
+
+    while(scpiScan != head){
+        c = SCPI_CH(scpiScan);
+        len = (scpiScan - scpiTail) & SERIAL_RX_MASK;
+        scpiScan = (scpiScan + 1) & SERIAL_RX_MASK;
+        if((c == '\n') || (c == '\r')){
+            if(scpiDrop == TRUE){
+                scpiDrop = FALSE;
+            } else if(len > 0){
+                scpiLine(scpiTail, len);
+            } else{}
+            scpiTail = scpiScan;
+        } else if((len >= SCPI_LINE_MAX) && (scpiDrop == FALSE)){
+            scpiDrop = TRUE;
+            scpiError(SCPI_ERR_OVERRUN);
+        } else{}
+    }
+}
+
+/********************************************************************
+* scpiLine - Runs each command of the line, separated by ';'
+********************************************************************/
+static void scpiLine(INT16U pos, INT16U len){
+    INT16U i;
+    INT16U start = 0;
+
+    scpiParseCycles = 0;
+    for(i = 0; i <= len; i++){
+        if((i == len) || (SCPI_CH(pos + i) == ';')){
+            scpiRun(pos + start, i - start);
+            start = i + 1;
+        }else{}
+    }
+    scpiLines++;
+    if(scpiParseCycles > scpiParseCyclesMax){
+        scpiParseCyclesMax = scpiParseCycles;
+    }else{}
+}
+
+/********************************************************************
+* scpiRun - Splits one command, looks it up and runs it. Only the
+*           split and the lookup count as parse cycles.
+********************************************************************/
+static void scpiRun(INT16U pos, INT16U len){
+    SCPI_CMD cmd;
+    INT8U entry;
+    INT8U node;
+    INT8U found = FALSE;
+    INT32U start = CYCLE_CNT_GET();
+
+    if(scpiSplit(pos, len, &cmd) == TRUE){
+        for(entry = 0; (entry < SCPI_TABLE_LEN) && (found == FALSE); entry++){
+            found = TRUE;
+            for(node = 0; node < SCPI_MAX_NODES; node++){
+                if(node < cmd.nodes){
+                    if((scpiTable[entry].mnem[node] == 0) ||
+                       (scpiMatch(&cmd.node[node], scpiTable[entry].mnem[node]) == FALSE)){
+                        found = FALSE;
+                    }else{}
+                } else if(scpiTable[entry].mnem[node] != 0){
+                    found = FALSE;
+                } else{}
+            }
+        }
+        scpiParseCycles += CYCLE_CNT_GET() - start;
+        if(found == TRUE){
+            scpiTable[entry - 1].exec(&cmd);
+        } else{
+            scpiError(SCPI_ERR_HEADER);
+        }
+    }else{}
+}
+
+/********************************************************************
+* scpiSplit - Header nodes separated by ':', an optional '?', spaces,
+*             then the rest less trailing spaces as the argument.
+*             A blank command is not an error and not run.
+*             Returns TRUE if cmd should be looked up.
+********************************************************************/
+static INT8U scpiSplit(INT16U pos, INT16U len, SCPI_CMD *cmd){
+    INT8C c;
+    INT8U ok = TRUE;
+    INT16U end = pos + len;
+
+    while((pos != end) && SCPI_IS_SPACE(SCPI_CH(pos))){
+        pos++;
+    }
+    while((end != pos) && SCPI_IS_SPACE(SCPI_CH(end - 1))){
+        end--;
+    }
+    cmd->nodes = 0;
+    cmd->query = FALSE;
+    cmd->arg.len = 0;
+    if(pos == end){
+        ok = FALSE;
+    }else{}
+
+    while((ok == TRUE) && (cmd->nodes < SCPI_MAX_NODES)){
+        cmd->node[cmd->nodes].pos = pos;
+        if((cmd->nodes == 0) && (SCPI_CH(pos) == '*')){
+            pos++;
+        }else{}
+        while((pos != end) && SCPI_IS_ALNUM(SCPI_CH(pos))){
+            pos++;
+        }
+        cmd->node[cmd->nodes].len = pos - cmd->node[cmd->nodes].pos;
+        cmd->nodes++;
+        if((pos != end) && (SCPI_CH(pos) == ':')){
+            pos++;
+            if(cmd->nodes >= SCPI_MAX_NODES){
+                scpiError(SCPI_ERR_HEADER);
+                ok = FALSE;
+            }else{}
+        } else{
+            break;
+        }
+    }
+    if(ok == TRUE){
+        if((pos != end) && (SCPI_CH(pos) == '?')){
+            cmd->query = TRUE;
+            pos++;
+        }else{}
+        c = (pos != end) ? SCPI_CH(pos) : ' ';
+        if(!SCPI_IS_SPACE(c)){              //Header runs into something else
+            scpiError(SCPI_ERR_SYNTAX);
+            ok = FALSE;
+        }else{}
+    }else{}
+    if(ok == TRUE){
+        while((pos != end) && SCPI_IS_SPACE(SCPI_CH(pos))){
+            pos++;
+        }
+        cmd->arg.pos = pos;
+        cmd->arg.len = end - pos;
+    }else{}
+    return ok;
+}
+
+/********************************************************************
+* scpiMatch - TRUE if tok is the short form of mnem, its leading
+*             upper case, or all of it, ignoring case
+********************************************************************/
+static INT8U scpiMatch(const SCPI_TOK *tok, const INT8C *mnem){
+    INT16U short_len = 0;
+    INT16U long_len = 0;
+    INT16U i;
+    INT8U match;
+
+    while(mnem[long_len] != 0){
+        if((mnem[long_len] < 'a') || (mnem[long_len] > 'z')){
+            short_len = long_len + 1;
+        }else{}
+        long_len++;
+    }
+    match = ((tok->len == short_len) || (tok->len == long_len)) ? TRUE : FALSE;
+    for(i = 0; (i < tok->len) && (match == TRUE); i++){
+        if(SCPI_UPPER(SCPI_CH(tok->pos + i)) != SCPI_UPPER(mnem[i])){
+            match = FALSE;
+        }else{}
+    }
+    return match;
+}
+
+/********************************************************************
+* scpiArgNum - Reads the argument as a decimal integer from min to max.
+*              Returns TRUE if it is one, else FALSE with the error set.
+********************************************************************/
+static INT8U scpiArgNum(const SCPI_CMD *cmd, INT32U min, INT32U max, INT32U *value){
+    INT16U i;
+    INT8C c;
+    INT32U num = 0;
+    INT8U ok = TRUE;
+
+    if(cmd->arg.len == 0){
+        scpiError(SCPI_ERR_MISSING);
+        ok = FALSE;
+    }else{}
+    for(i = 0; (i < cmd->arg.len) && (ok == TRUE); i++){
+        c = SCPI_CH(cmd->arg.pos + i);
+        if((c < '0') || (c > '9')){
+            scpiError(SCPI_ERR_DATA_TYPE);
+            ok = FALSE;
+        } else if(num > max){                   //Stop before it can overflow
+            i = cmd->arg.len;
+        } else{
+            num = (num * 10) + (INT32U)(c - '0');
+        }
+    }
+    if((ok == TRUE) && ((num < min) || (num > max))){
+        scpiError(SCPI_ERR_RANGE);
+        ok = FALSE;
+    }else{}
+    *value = num;
+    return ok;
+}
+
+/********************************************************************
+* scpiNumQuery - Replies with value
+********************************************************************/
+static void scpiNumQuery(INT32U value){
+    INT8C reply[12];
+    INT8U len;
+
+    len = FmtDec(reply, value, 0);
+    reply[len] = '\n';
+    SerialWrite(reply, len + 1);
+}
+
+/********************************************************************
+* Command handlers
+********************************************************************/
+static void scpiIdn(const SCPI_CMD *cmd){
+    static const INT8C idn[] = "K65TWR,Function Generator,0,1.0\n";
+
+    if(cmd->query == TRUE){
+        SerialWrite(idn, sizeof(idn) - 1);
+    } else{
+        scpiError(SCPI_ERR_HEADER);
+    }
+}
+
+static void scpiCls(const SCPI_CMD *cmd){
+    (void)cmd;
+    scpiErr = SCPI_ERR_NONE;
+}
+
+static void scpiFreq(const SCPI_CMD *cmd){
+    WAVE_W wave;
+    INT32U freq;
+
+    WaveGet(&wave);
+    if(cmd->query == TRUE){
+        scpiNumQuery(wave.freq);
+    } else if(scpiArgNum(cmd, SCPI_FREQ_MIN, SCPI_FREQ_MAX, &freq) == TRUE){
+        scpiSweepOn = FALSE;
+        wave.freq = (INT16U)freq;
+        scpiSetWave(&wave);
+    } else{}
+}
+
+static void scpiAmpl(const SCPI_CMD *cmd){
+    WAVE_W wave;
+    INT32U amp;
+
+    if(cmd->query == TRUE){
+        WaveGet(&wave);
+        scpiNumQuery(wave.amp);
+    } else if(scpiArgNum(cmd, 0, WAVE_AMP_MAX, &amp) == TRUE){
+        WaveSetAmp((INT8U)amp);                 //Ramped, like the touch gesture
+        scpiChanged();
+    } else{}
+}
+
+static void scpiShape(const SCPI_CMD *cmd){
+    WAVE_W wave;
+
+    WaveGet(&wave);
+    if(cmd->query == TRUE){
+        if(wave.waveshape == SIN){
+            SerialWrite("SIN\n", 4);
+        } else{
+            SerialWrite("TRI\n", 4);
+        }
+    } else if(cmd->arg.len == 0){
+        scpiError(SCPI_ERR_MISSING);
+    } else if(scpiMatch(&cmd->arg, "SINusoid") == TRUE){
+        wave.waveshape = SIN;
+        scpiSetWave(&wave);
+    } else if(scpiMatch(&cmd->arg, "TRIangle") == TRUE){
+        wave.waveshape = TRI;
+        scpiSetWave(&wave);
+    } else{
+        scpiError(SCPI_ERR_ILLEGAL);
+    }
+}
+
+static void scpiSweepStart(const SCPI_CMD *cmd){
+    INT32U freq;
+
+    if(cmd->query == TRUE){
+        scpiNumQuery(scpiSweepFrom);
+    } else if(scpiArgNum(cmd, SCPI_FREQ_MIN, SCPI_FREQ_MAX, &freq) == TRUE){
+        scpiSweepFrom = (INT16U)freq;
+    } else{}
+}
+
+static void scpiSweepStop(const SCPI_CMD *cmd){
+    INT32U freq;
+
+    if(cmd->query == TRUE){
+        scpiNumQuery(scpiSweepTo);
+    } else if(scpiArgNum(cmd, SCPI_FREQ_MIN, SCPI_FREQ_MAX, &freq) == TRUE){
+        scpiSweepTo = (INT16U)freq;
+    } else{}
+}
+
+static void scpiSweepTime(const SCPI_CMD *cmd){
+    INT32U ms;
+
+    if(cmd->query == TRUE){
+        scpiNumQuery(scpiSweepMs);
+    } else if(scpiArgNum(cmd, SCPI_SWEEP_MS_MIN, SCPI_SWEEP_MS_MAX, &ms) == TRUE){
+        scpiSweepMs = (INT16U)ms;
+    } else{}
+}
+
+static void scpiSweepState(const SCPI_CMD *cmd){
+    OS_ERR os_err;
+
+    if(cmd->query == TRUE){
+        scpiNumQuery((scpiSweepOn == TRUE) ? 1 : 0);
+    } else if(cmd->arg.len == 0){
+        scpiError(SCPI_ERR_MISSING);
+    } else if((scpiMatch(&cmd->arg, "ON") == TRUE) || (scpiMatch(&cmd->arg, "1") == TRUE)){
+        scpiSweepOn = TRUE;
+        scpiSweepBegin = OSTimeGet(&os_err);
+        scpiSweepDue = scpiSweepBegin;
+    } else if((scpiMatch(&cmd->arg, "OFF") == TRUE) || (scpiMatch(&cmd->arg, "0") == TRUE)){
+        scpiSweepOn = FALSE;
+    } else{
+        scpiError(SCPI_ERR_ILLEGAL);
+    }
+}
+
+static void scpiPresetSave(const SCPI_CMD *cmd){
+    WAVE_W wave;
+    INT32U slot;
+
+    if(cmd->query == TRUE){
+        scpiError(SCPI_ERR_HEADER);
+    } else if(scpiArgNum(cmd, 0, PRESET_SLOTS - 1, &slot) == TRUE){
+        WaveGet(&wave);
+        if(PresetSave((INT8U)slot, &wave) == FALSE){
+            scpiError(SCPI_ERR_EXEC);
+        }else{}
+    } else{}
+}
+
+static void scpiPresetRecall(const SCPI_CMD *cmd){
+    WAVE_W wave;
+    INT32U slot;
+
+    if(cmd->query == TRUE){
+        scpiError(SCPI_ERR_HEADER);
+    } else if(scpiArgNum(cmd, 0, PRESET_SLOTS - 1, &slot) == TRUE){
+        if(PresetGet((INT8U)slot, &wave) == TRUE){
+            scpiSweepOn = FALSE;
+            scpiSetWave(&wave);
+        } else{
+            scpiError(SCPI_ERR_EXEC);           //Never saved
+        }
+    } else{}
+}
+
+static void scpiSysError(const SCPI_CMD *cmd){
+    INT8C reply[SCPI_REPLY_MAX];
+    const INT8C *text;
+    INT8U len = 0;
+
+    if(cmd->query == TRUE){
+        switch(scpiErr){
+        case SCPI_ERR_SYNTAX:       text = "Syntax error";          break;
+        case SCPI_ERR_DATA_TYPE:    text = "Data type error";       break;
+        case SCPI_ERR_MISSING:      text = "Missing parameter";     break;
+        case SCPI_ERR_HEADER:       text = "Undefined header";      break;
+        case SCPI_ERR_EXEC:         text = "Execution error";       break;
+        case SCPI_ERR_RANGE:        text = "Data out of range";     break;
+        case SCPI_ERR_ILLEGAL:      text = "Illegal parameter value"; break;
+        case SCPI_ERR_OVERRUN:      text = "Input buffer overrun";  break;
+        default:                    text = "No error";              break;
+        }
+        if(scpiErr < 0){
+            reply[len] = '-';
+            len++;
+        }else{}
+        len += FmtDec(&reply[len], (INT32U)((scpiErr < 0) ? -scpiErr : scpiErr), 0);
+        reply[len++] = ',';
+        reply[len++] = '"';
+        while((*text != 0) && (len < (SCPI_REPLY_MAX - 2))){
+            reply[len++] = *text++;
+        }
+        reply[len++] = '"';
+        reply[len++] = '\n';
+        SerialWrite(reply, len);
+        scpiErr = SCPI_ERR_NONE;
+    } else{
+        scpiError(SCPI_ERR_HEADER);
+    }
+}
+
+static void scpiSysLatency(const SCPI_CMD *cmd){
+    INT8C reply[SCPI_REPLY_MAX];
+    INT32U last_us;
+    INT32U max_us;
+    INT8U len;
+
+    if(cmd->query == TRUE){
+        WaveLatencyGet(&last_us, &max_us);
+        len = FmtDec(reply, last_us, 0);
+        reply[len++] = ',';
+        len += FmtDec(&reply[len], max_us, 0);
+        reply[len++] = '\n';
+        SerialWrite(reply, len);
+    } else{
+        scpiError(SCPI_ERR_HEADER);
+    }
+}
+
+static void scpiSysParse(const SCPI_CMD *cmd){
+    INT8C reply[SCPI_REPLY_MAX];
+    INT8U len;
+
+    if(cmd->query == TRUE){
+        len = FmtDec(reply, scpiLines, 0);
+        reply[len++] = ',';
+        len += FmtDec(&reply[len], scpiParseCyclesMax, 0);
+        reply[len++] = '\n';
+        SerialWrite(reply, len);
+    } else{
+        scpiError(SCPI_ERR_HEADER);
+    }
+}
+
+/********************************************************************
+* scpiSetWave - Sends a wave changed by a command, timed from its line
+********************************************************************/
+static void scpiSetWave(const WAVE_W *wave){
+    WAVE_W send = *wave;
+
+    WaveSetLive(&send, scpiLineTime);
+    scpiChanged();
+}
+
+/********************************************************************
+* scpiSweepStep - Sends the sweep frequency for now once a step is due
+********************************************************************/
+static void scpiSweepStep(void){
+    OS_ERR os_err;
+    OS_TICK now;
+    INT32U span;
+    INT32U at;
+    WAVE_W wave;
+
+    if(scpiSweepOn == TRUE){
+        now = OSTimeGet(&os_err);
+        if((OS_TICK)(now - scpiSweepDue) < (OS_TICK)0x80000000U){   //Due, wrap safe
+            scpiSweepDue = now + APP_CFG_SCPI_SWEEP_STEP_TICKS;
+            span = ((INT32U)scpiSweepMs * OSCfg_TickRate_Hz) / 1000U;
+            at = (now - scpiSweepBegin) % span;
+            WaveGet(&wave);
+            wave.freq = (INT16U)((INT32S)scpiSweepFrom +
+                        ((((INT32S)scpiSweepTo - (INT32S)scpiSweepFrom) * (INT32S)at) / (INT32S)span));
+            WaveSet(&wave);
+            scpiChanged();
+        }else{}
+    }else{}
+}
+
+/********************************************************************
+* scpiChanged - Tells the notify group the wave was changed
+********************************************************************/
+static void scpiChanged(void){
+    OS_ERR os_err;
+
+    if(scpiNotifyGrp != (OS_FLAG_GRP *)0){
+        (void)OSFlagPost(scpiNotifyGrp, scpiNotifyFlag, OS_OPT_POST_FLAG_SET, &os_err);
+    }else{}
+}
+
+/********************************************************************
+* scpiError - Keeps err for SYSTem:ERRor?, replacing the last
+********************************************************************/
+static void scpiError(INT16S err){
+    scpiErr = err;
+}
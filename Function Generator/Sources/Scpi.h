@@ -0,0 +1,52 @@
+/*******************************************************************************
+* Scpi.h - Project header file for Scpi.c
+*
+* SCPI style commands from the serial port, one or more per line separated
+* by ';', each line ended by LF or CR. Mnemonics match in their short or
+* long form, case insensitive. Numbers are unsigned decimal integers.
+*
+*   *IDN?                       identification
+*   *CLS                        clears the error
+*   FREQuency <10-10000>        Hz, also FREQuency?
+*   AMPLitude <0-20>            also AMPLitude?
+*   SHAPe SINusoid|TRIangle     also SHAPe?
+*   SWEep:STARt <10-10000>      Hz, also SWEep:STARt?
+*   SWEep:STOP <10-10000>       Hz, also SWEep:STOP?
+*   SWEep:TIME <10-60000>       ms from start to stop, also SWEep:TIME?
+*   SWEep:STATe ON|OFF|1|0      also SWEep:STATe?
+*   PRESet:SAVE <0-9>           saves the wave playing
+*   PRESet:RECall <0-9>
+*   SYSTem:ERRor?               "<code>,"<text>"", then clears it
+*   SYSTem:LATency?             "<last>,<max>" line to DAC, microseconds
+*   SYSTem:PARSe?               "<lines>,<max cycles>" parsed, worst line
+*
+* Only the last error is kept, it is not a queue.
+*******************************************************************************/
+#ifndef SOURCES_SCPI_H_
+#define SOURCES_SCPI_H_
+
+/********************************************************************
+* ScpiInit - Starts the serial port and creates the command task
+*
+* Description:  Call after WaveInit() and PresetInit().
+*
+* Return value: None
+*
+* Arguments:    None
+********************************************************************/
+void ScpiInit(void);
+
+/********************************************************************
+* ScpiNotify - Sets flag in grp whenever a command changes the wave
+*
+* Description:  So the UI can redraw what is playing. Call once,
+*               before ScpiInit().
+*
+* Return value: None
+*
+* Arguments:    grp  - Event flag group to post to
+*               flag - Flag to set
+********************************************************************/
+void ScpiNotify(OS_FLAG_GRP *grp, OS_FLAGS flag);
+
+#endif /* SOURCES_SCPI_H_ */
@@ -0,0 +1,108 @@
+/*******************************************************************************
+* Trace.c - In-RAM event trace. Timestamped 8 byte records are written to a
+*           ring buffer so task and ISR timing can be read from a RAM dump
+*           instead of needing a logic analyzer on the debug bits.
+*
+*           With APP_CFG_TRACE_EN enabled in app_cfg.h, the DBx_TURN_ON(),
+*           DBx_TURN_OFF() and DBx_TOGGLE() macros in K65TWR_GPIO.h also
+*           emit TRACE_ID_DB_xxx events, so every existing debug bit site
+*           is recorded without changes.
+*
+*           OS_CFG_TRACE_EN in os_cfg.h follows APP_CFG_TRACE_EN, so the
+*           kernel's trace hooks record task switches, ISR entry/exit and
+*           semaphore, mutex and queue activity here too, see
+*           os_trace_events.h. With it disabled main() does not call
+*           TraceInit() and nothing is recorded.
+*******************************************************************************/
+#include "MCUType.h"
+#include "app_cfg.h"
+#include "os.h"
+#include "CycleCnt.h"
+#include "Trace.h"
+
+#if (APP_CFG_TRACE_EN == DEF_ENABLED)
+TRACE_REC traceBuffer[TRACE_BUF_SIZE];
+volatile INT32U traceIndex;
+const INT8C *traceObjNames[TRACE_OBJ_MAX];
+
+static volatile INT8U traceStopped;
+static INT16U traceObjCnt;
+
+/********************************************************************
+* TraceInit - Starts the cycle counter and empties the trace buffer
+********************************************************************/
+void TraceInit(void){
+    INT32U i;
+
+    CycleCntInit();
+    for(i = 0; i < TRACE_BUF_SIZE; i++){
+        traceBuffer[i].ts = 0;
+        traceBuffer[i].id = 0;
+        traceBuffer[i].arg = 0;
+        traceBuffer[i].data = 0;
+    }
+    for(i = 0; i < TRACE_OBJ_MAX; i++){
+        traceObjNames[i] = (const INT8C *)0;
+    }
+    traceIndex = 0;
+    traceObjCnt = 1;
+    traceStopped = FALSE;
+}
+
+/********************************************************************
+* TraceEvent - Appends one record to the trace buffer
+********************************************************************/
+void TraceEvent(INT8U id, INT8U arg, INT16U data){
+    INT32U index;
+    INT32U ts;
+    TRACE_REC *rec;
+
+    if(traceStopped == FALSE){
+        //An exception between LDREX and STREX clears the monitor, so the
+        //stamp is taken again on the retry and slots stay in time order
+        do{
+            index = __LDREXW((volatile uint32_t *)&traceIndex);
+            ts = CYCLE_CNT_GET();
+        }while(__STREXW(index + 1, (volatile uint32_t *)&traceIndex) != 0);
+
+        rec = &traceBuffer[index & (TRACE_BUF_SIZE - 1)];
+        rec->ts = ts;
+        rec->id = id;
+        rec->arg = arg;
+        rec->data = data;
+    }else{ /* Frozen for a dump */
+    }
+}
+
+/********************************************************************
+* TraceObjRegister - Gives a task or kernel object a trace ID
+********************************************************************/
+INT16U TraceObjRegister(INT8U id, INT8U arg, const INT8C *name){
+    INT16U obj_id = 0;
+    CPU_SR_ALLOC();
+
+    CPU_CRITICAL_ENTER();
+    if(traceObjCnt < TRACE_OBJ_MAX){
+        obj_id = traceObjCnt;
+        traceObjCnt++;
+        traceObjNames[obj_id] = name;
+    }else{ /* Table full, object stays unnamed */
+    }
+    CPU_CRITICAL_EXIT();
+
+    TraceEvent(id, arg, obj_id);
+    return obj_id;
+}
+
+/********************************************************************
+* TraceStart/TraceStop - Resume or freeze recording
+********************************************************************/
+void TraceStart(void){
+    traceStopped = FALSE;
+}
+
+void TraceStop(void){
+    traceStopped = TRUE;
+}
+
+#endif /* APP_CFG_TRACE_EN */
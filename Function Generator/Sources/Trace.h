@@ -0,0 +1,95 @@
+/*******************************************************************************
+* Trace.h - Project header file for Trace.c
+*
+* Record format (8 bytes, little endian, in traceBuffer[]):
+*   ts   - INT32U DWT cycle count when the record was reserved, so records
+*          are in timestamp order even when an ISR preempts a writer
+*   id   - INT8U  event id, TRACE_ID_xxx below
+*   arg  - INT8U  event argument, the debug bit number for TRACE_ID_DB_xxx
+*   data - INT16U event data, 0 for debug bit events
+*
+* Ids 0x01-0x0F are defined here, 0x10-0x3F are uC/OS-III kernel events
+* defined in os_trace_events.h.
+*
+* traceIndex counts every record ever reserved. The newest record is at
+* (traceIndex-1) & (TRACE_BUF_SIZE-1), and when traceIndex > TRACE_BUF_SIZE
+* the oldest surviving record is at traceIndex & (TRACE_BUF_SIZE-1). A RAM
+* dump of traceIndex and traceBuffer is all a decoder needs.
+*******************************************************************************/
+#ifndef SOURCES_TRACE_H_
+#define SOURCES_TRACE_H_
+
+#define TRACE_BUF_SIZE 1024U            //Records, must be a power of 2
+#define TRACE_OBJ_MAX 48U               //Named tasks/kernel objects, ID 0 is unnamed
+
+// Event ids
+#define TRACE_ID_DB_OFF    0x01U
+#define TRACE_ID_DB_ON     0x02U
+#define TRACE_ID_DB_TOGGLE 0x03U
+#define TRACE_ID_DMA_LATE  0x04U     //arg: PIT0 periods late, data: bus cycles
+#define TRACE_ID_WAVE_LAT  0x05U     //arg: 0, data: key to DAC us, 65535 if longer
+
+typedef struct{
+    INT32U ts;
+    INT8U id;
+    INT8U arg;
+    INT16U data;
+} TRACE_REC;
+
+extern TRACE_REC traceBuffer[TRACE_BUF_SIZE];
+extern volatile INT32U traceIndex;
+extern const INT8C *traceObjNames[TRACE_OBJ_MAX];
+
+/********************************************************************
+* TraceInit - Starts the cycle counter and empties the trace buffer
+*
+* Description:  Call once from main() before OSInit() so the kernel's
+*               own tasks and objects are registered.
+*
+* Return value: None
+*
+* Arguments:    None
+********************************************************************/
+void TraceInit(void);
+
+/********************************************************************
+* TraceEvent - Appends one record to the trace buffer
+*
+* Description:  Lock-free, may be called from tasks and ISRs. The slot
+*               is reserved with LDREX/STREX so a writer that preempts
+*               another gets the next slot instead of sharing one. The
+*               timestamp is read inside the reserve, so a preempted
+*               reserve retries with a new one.
+*               Does nothing while the trace is stopped.
+*
+* Return value: None
+*
+* Arguments:    id - TRACE_ID_xxx event id
+*               arg - event argument
+*               data - event data
+********************************************************************/
+void TraceEvent(INT8U id, INT8U arg, INT16U data);
+
+/********************************************************************
+* TraceObjRegister - Gives a task or kernel object a trace ID
+*
+* Description:  Stores name in traceObjNames[] under the next free ID and
+*               records an event with the ID as data. Used by the
+*               OS_TRACE_xxx_CREATE hooks.
+*
+* Return value: The new ID, or 0 once all TRACE_OBJ_MAX are used
+*
+* Arguments:    id - TRACE_ID_xxx event id to record
+*               arg - event argument
+*               name - name of the task or object
+********************************************************************/
+INT16U TraceObjRegister(INT8U id, INT8U arg, const INT8C *name);
+
+/********************************************************************
+* TraceStart/TraceStop - Resume or freeze recording, for example to
+*               keep the events leading up to a fault for a RAM dump.
+********************************************************************/
+void TraceStart(void);
+void TraceStop(void);
+
+#endif /* SOURCES_TRACE_H_ */
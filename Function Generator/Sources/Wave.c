@@ -1,186 +1,474 @@
-/*
- * Wave.c
- *  Source File for the Wave generator module.
- *
- *
- *  Created on: Feb 9, 2018
- *      Author: Mesecar
- */
-
-
-#include "MCUType.h"
-#include "app_cfg.h"
-#include "os.h"
-#include "Wave.h"
-#include "DMA.h"
-#include "K65TWR_GPIO.h"
-
-#define CONVERTION_FACTOR 2426U
-
-
-static OS_TCB ProcessTaskTCB;
-static CPU_STK ProcessTaskStk[APP_CFG_PROCESS_TASK_STK_SIZE];
-// uCOS stuff
-static OS_MUTEX WaveMutexKey;
-static WAVE_W CurrentSignal; // The Current Signal to be Produced
-
-
-static void ProcessTask(void *p_arg);
-static q31_t FreqToQ31(INT16U freq, INT16U step);
-
-static void ProcessTask(void *p_arg);
-/*
- * WaveInit()
- * Public Function
- *
- * Initializes the Wave module:
- *
- * ~Rod Mesecar, 2/9/18
- */
-void WaveInit(void){
-    OS_ERR os_err;
-
-    OSMutexCreate(&WaveMutexKey, "Wave Mutex Key", &os_err);
-
-    OSTaskCreate(&ProcessTaskTCB,                    //Create UITask
-                 "Process Task",
-                 ProcessTask,
-                 (void *) 0,
-                 APP_CFG_PROCESS_TASK_PRIO,
-                 &ProcessTaskStk[0],
-                 (APP_CFG_PROCESS_TASK_STK_SIZE / 10u),
-                 APP_CFG_PROCESS_TASK_STK_SIZE,
-                 0,
-                 0,
-                 (void *) 0,
-                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR),
-                 &os_err);
-        while(os_err != OS_ERR_NONE){}
-
-    // Default Values
-    CurrentSignal.amp = 20;
-    CurrentSignal.freq= 100;
-    CurrentSignal.waveshape = SIN;
-
-}
-
-/*
- * WaveGet()
- * Public Function
- *
- * When Called, pends on WaveMutexKey and copies the contents of
- * CurrentSignal to the address of the passed pointer.
- *
- * ~Rod Mesecar, 2/9/18
- */
-void WaveGet(WAVE_W *passWave){
-    OS_ERR os_err;
-    OSMutexPend(&WaveMutexKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
-    *passWave = CurrentSignal;
-    OSMutexPost(&WaveMutexKey, OS_OPT_POST_NONE, &os_err);
-}
-
-
-/*
- * WaveSet()
- * Public Function
- *
- * When Called, pends on WaveMutexKey and copies the contents at
- * the address of the passed pointer to CurrentSignal
- *
- * ~Rod Mesecar, 2/9/18
- */
-void WaveSet(WAVE_W *passWave){
-    OS_ERR os_err;
-    OSMutexPend(&WaveMutexKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
-    CurrentSignal = *passWave;
-    OSMutexPost(&WaveMutexKey, OS_OPT_POST_NONE, &os_err);
-}
-
-static void ProcessTask(void *p_arg){
-    (void)p_arg;
-    OS_ERR os_err;
-    INT16U sample_index;
-    INT8U block_index;
-    INT16U ramp_max;
-    INT16U ramp_min;
-    INT32U ramp_slope_q15;
-    INT32U ramp_sample_period_q15;
-    INT32U sin_sample_period_q15;
-    INT16U wave_amp = 0;
-    INT16U wave_freq = 0;
-    INT32U sample_counter = 0;
-    INT8U wave_shape;
-    q31_t sin_input_q31;
-    q31_t sin_sample;
-
-    while(1){
-        DB0_TURN_OFF();
-        block_index = DMABlockDonePend(&os_err);
-        DB0_TURN_ON();
-
-        OSMutexPend(&WaveMutexKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
-        while(os_err != OS_ERR_NONE){}
-        wave_amp = CurrentSignal.amp;
-        wave_freq = CurrentSignal.freq;
-        wave_shape = CurrentSignal.waveshape;
-        OSMutexPost(&WaveMutexKey, OS_OPT_POST_NONE, &os_err);
-        while(os_err != OS_ERR_NONE){}
-        sample_index = 0;
-        switch(wave_shape){
-            case TRI:
-                ramp_max = 2048 + ((1707*wave_amp)/20);
-                ramp_min = 2048 - ((1707*wave_amp)/20);
-                ramp_sample_period_q15 = ((48000<<15)/wave_freq);
-                ramp_slope_q15 = ((3414*wave_amp)/20);
-                ramp_slope_q15 = (ramp_slope_q15<<15)/((ramp_sample_period_q15>>15)/2);
-
-                 while(sample_index < 64){
-                    if((sample_counter<<15) >= ramp_sample_period_q15){
-                        sample_counter = 1;
-                    }else{}
-
-                    if((sample_counter<<15) < (ramp_sample_period_q15/2)){
-                        wavCurSamples[block_index][sample_index] = ramp_min + ((sample_counter*ramp_slope_q15>>15));
-                    }else if((sample_counter<<15) < (ramp_sample_period_q15)){
-                        wavCurSamples[block_index][sample_index] = ramp_max - (((sample_counter-((ramp_sample_period_q15/2)>>15))*(ramp_slope_q15)>>15));
-                    }else{}
-
-                    sample_index++;
-                    sample_counter++;
-                }
-                break;
-            case SIN:
-                while(sample_index < 64){
-                    sin_sample_period_q15 = ((48000<<15)/wave_freq);
-
-                    if((sample_counter<<15) >= sin_sample_period_q15){
-                        sample_counter = 0;
-                    }else{}
-
-                    sin_input_q31 = FreqToQ31(wave_freq, sample_counter);
-                    sin_sample = arm_sin_q31(sin_input_q31);
-                    sin_sample = 2048 + (((sin_sample>>10)*1707*wave_amp)/20);
-                    wavCurSamples[block_index][sample_index] = sin_sample;
-                    sample_index++;
-                    sample_counter++;
-                }
-                break;
-
-            default:
-                break;
-        }
-    }
-}
-/*
- * FreqtoQ31()
- *
- * Converts the passsed frequency and step into a q31_t
- * and returns. Should be used with arm_sin_q31
- *
- *~Rod Mesecar 2/16/18
- */
-static q31_t FreqToQ31(INT16U freq, INT16U step){
-	q31_t result = (q31_t)(CONVERTION_FACTOR * freq* step);
-	return result;
-}
+/*
+ * Wave.c
+ *  Source File for the Wave generator module.
+ *
+ *
+ *  Created on: Feb 9, 2018
+ *      Author: Mesecar
+ */
+
+
+#include "MCUType.h"
+#include "app_cfg.h"
+#include "os.h"
+#include "Wave.h"
+#include "DMA.h"
+#include "K65TWR_GPIO.h"
+#include "CycleCnt.h"
+#include "Trace.h"
+
+#define WAVE_MID 2048                   // DAC code of 0V out
+#define WAVE_PEAK 1707                  // Full scale peak around WAVE_MID
+#define WAVE_PHASE_PER_HZ 89550U        // 2^32/Fs, Fs = 60MHz/(PIT0_TIMER_VALUE+1)
+#define WAVE_CYCLES_PER_US (DEFAULT_SYSTEM_CLOCK/1000000U)
+#define WAVE_CYCLES_PER_SAMPLE ((PIT0_TIMER_VALUE+1U)*3U) // Core clock is 3x the bus
+#define WAVE_FLAG_BLOCK ((OS_FLAGS)0x01u)  // DMA finished a block
+#define WAVE_FLAG_CHANGE ((OS_FLAGS)0x02u) // CurrentSignal changed
+#define WAVE_BUF_SAMPLES (DMA_TWOBLOCKS*DMA_64SAMPLES_PERBLOCK)
+#define WAVE_SAFE_SAMPLES 4U // Re-render this far ahead of the DMA, ~83us
+
+
+static OS_TCB ProcessTaskTCB;
+static CPU_STK ProcessTaskStk[APP_CFG_PROCESS_TASK_STK_SIZE];
+// uCOS stuff
+static OS_MUTEX WaveMutexKey;
+static OS_FLAG_GRP WaveFlags;
+static WAVE_W CurrentSignal; // The Current Signal to be Produced
+
+// Latency of a WaveSetLive() change, all under WaveMutexKey
+static INT8U waveChangeTimed = FALSE;
+static INT32U waveChangeCycles; // CYCLE_CNT_GET() when set
+static OS_TICK waveChangeKeyTicks; // Key press to set
+static INT32U waveLatLastUs;
+static INT32U waveLatMaxUs;
+static INT32U waveLateRenders; // Re-renders the DMA caught up with
+
+// What was rendered into each block, from sample from to its end, so the
+// renderer state at any later sample can be worked out again
+typedef struct{
+    INT8U from;
+    WAVE_RENDER start; // State at sample from
+    WAVE_W wave;
+} WAVE_SEG;
+
+// ProcessTask only
+static WAVE_SEG waveSeg[DMA_TWOBLOCKS];
+static WAVE_RENDER waveEnd = {0, 0}; // State after the last sample rendered, silence at first
+static INT8U waveQueued = 0; // Block last rendered for a block done
+
+
+static void ProcessTask(void *p_arg);
+static void waveRender(INT16U *dest, INT16U count, const WAVE_W *wave, WAVE_RENDER *render);
+static void waveGainRamp(INT16U *dest, INT16U count, WAVE_RENDER *render, INT32S target_q15);
+static void waveRenderSeg(INT8U block, INT8U from, const WAVE_RENDER *start, const WAVE_W *wave);
+static void waveSegState(INT8U block, INT8U offset, WAVE_RENDER *state);
+static INT8U waveRerender(const WAVE_W *wave, INT8U *first);
+static void waveChanged(void);
+static void waveLatRecord(INT8U first, INT32U set_cycles, OS_TICK key_ticks);
+
+/*
+ * WaveInit()
+ * Public Function
+ *
+ * Initializes the Wave module:
+ *
+ * ~Rod Mesecar, 2/9/18
+ */
+void WaveInit(void){
+    OS_ERR os_err;
+
+    OSMutexCreate(&WaveMutexKey, "Wave Mutex Key", &os_err);
+    while(os_err != OS_ERR_NONE){}
+    OSFlagCreate(&WaveFlags, "Wave Flags", (OS_FLAGS)0, &os_err);
+    while(os_err != OS_ERR_NONE){}
+    DMANotify(&WaveFlags, WAVE_FLAG_BLOCK);
+
+    OSTaskCreate(&ProcessTaskTCB,                    //Create UITask
+                 "Process Task",
+                 ProcessTask,
+                 (void *) 0,
+                 APP_CFG_PROCESS_TASK_PRIO,
+                 &ProcessTaskStk[0],
+                 (APP_CFG_PROCESS_TASK_STK_SIZE / 10u),
+                 APP_CFG_PROCESS_TASK_STK_SIZE,
+                 0,
+                 0,
+                 (void *) 0,
+                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR),
+                 &os_err);
+        while(os_err != OS_ERR_NONE){}
+
+    // Default Values
+    CurrentSignal.amp = 20;
+    CurrentSignal.freq= 100;
+    CurrentSignal.waveshape = SIN;
+
+}
+
+/*
+ * WaveGet()
+ * Public Function
+ *
+ * When Called, pends on WaveMutexKey and copies the contents of
+ * CurrentSignal to the address of the passed pointer.
+ *
+ * ~Rod Mesecar, 2/9/18
+ */
+void WaveGet(WAVE_W *passWave){
+    OS_ERR os_err;
+    OSMutexPend(&WaveMutexKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
+    *passWave = CurrentSignal;
+    OSMutexPost(&WaveMutexKey, OS_OPT_POST_NONE, &os_err);
+}
+
+
+/*
+ * WaveSet()
+ * Public Function
+ *
+ * When Called, pends on WaveMutexKey and copies the contents at
+ * the address of the passed pointer to CurrentSignal
+ *
+ * ~Rod Mesecar, 2/9/18
+ */
+void WaveSet(WAVE_W *passWave){
+    OS_ERR os_err;
+    OSMutexPend(&WaveMutexKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
+    CurrentSignal = *passWave;
+    OSMutexPost(&WaveMutexKey, OS_OPT_POST_NONE, &os_err);
+    waveChanged();
+}
+
+/*
+ * WaveSetLive()
+ * Public Function
+ *
+ * WaveSet() that also stamps the change for the latency measurement.
+ * A change not yet rendered when the next one comes is measured from
+ * the newer one.
+ */
+void WaveSetLive(WAVE_W *passWave, OS_TICK key_time){
+    OS_ERR os_err;
+    OSMutexPend(&WaveMutexKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
+    CurrentSignal = *passWave;
+    waveChangeKeyTicks = OSTimeGet(&os_err) - key_time;
+    waveChangeCycles = CYCLE_CNT_GET();
+    waveChangeTimed = TRUE;
+    OSMutexPost(&WaveMutexKey, OS_OPT_POST_NONE, &os_err);
+    waveChanged();
+}
+
+/*
+ * WaveLatencyGet()
+ * Public Function
+ *
+ * Copies out the last and longest key to DAC latency in microseconds.
+ */
+void WaveLatencyGet(INT32U *last_us, INT32U *max_us){
+    OS_ERR os_err;
+    OSMutexPend(&WaveMutexKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
+    *last_us = waveLatLastUs;
+    *max_us = waveLatMaxUs;
+    OSMutexPost(&WaveMutexKey, OS_OPT_POST_NONE, &os_err);
+}
+
+/*
+ * WaveSetAmp()
+ * Public Function
+ *
+ * Sets only the amplitude, leaving frequency and shape as they are.
+ */
+void WaveSetAmp(INT8U amp){
+    OS_ERR os_err;
+    if(amp > WAVE_AMP_MAX){
+        amp = WAVE_AMP_MAX;
+    }else{}
+    OSMutexPend(&WaveMutexKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
+    CurrentSignal.amp = amp;
+    OSMutexPost(&WaveMutexKey, OS_OPT_POST_NONE, &os_err);
+    waveChanged();
+}
+
+/*
+ * waveChanged()
+ * Private Function
+ *
+ * Wakes ProcessTask to re-render the queued block with CurrentSignal.
+ */
+static void waveChanged(void){
+    OS_ERR os_err;
+    (void)OSFlagPost(&WaveFlags, WAVE_FLAG_CHANGE, OS_OPT_POST_FLAG_SET, &os_err);
+    while(os_err != OS_ERR_NONE){}
+}
+
+/*
+ * ProcessTask()
+ *
+ * Renders the block the DMA just finished, which plays after the one
+ * now playing. On a change, waveRerender() renders again from a few
+ * samples ahead of the DMA, so a change is heard within WAVE_SAFE_SAMPLES
+ * plus the render instead of at the next block boundary or the one after.
+ */
+static void ProcessTask(void *p_arg){
+    (void)p_arg;
+    OS_ERR os_err;
+    OS_FLAGS flags;
+    INT8U rendered;
+    INT8U first = 0;
+    WAVE_W wave;
+    INT8U lat_pending = FALSE;
+    INT32U lat_cycles = 0;
+    OS_TICK lat_ticks = 0;
+
+    while(1){
+        DB0_TURN_OFF();
+        flags = OSFlagPend(&WaveFlags, (WAVE_FLAG_BLOCK | WAVE_FLAG_CHANGE), 0,
+                           (OS_OPT_PEND_FLAG_SET_ANY | OS_OPT_PEND_FLAG_CONSUME | OS_OPT_PEND_BLOCKING),
+                           (CPU_TS *)0, &os_err);
+        while(os_err != OS_ERR_NONE){}
+        DB0_TURN_ON();
+
+        OSMutexPend(&WaveMutexKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
+        while(os_err != OS_ERR_NONE){}
+        wave = CurrentSignal;
+        if(waveChangeTimed == TRUE){
+            waveChangeTimed = FALSE;
+            lat_pending = TRUE;
+            lat_cycles = waveChangeCycles;
+            lat_ticks = waveChangeKeyTicks;
+        }else{}
+        OSMutexPost(&WaveMutexKey, OS_OPT_POST_NONE, &os_err);
+        while(os_err != OS_ERR_NONE){}
+
+        rendered = FALSE;
+        if((flags & WAVE_FLAG_BLOCK) != 0){
+            waveQueued = DMABlockReady();
+            waveRenderSeg(waveQueued, 0, &waveEnd, &wave);
+            first = waveQueued*DMA_64SAMPLES_PERBLOCK;
+            rendered = TRUE;
+        }else{}
+        if((flags & WAVE_FLAG_CHANGE) != 0){
+            if(waveRerender(&wave, &first) == TRUE){
+                rendered = TRUE;
+            }else{}
+        }else{}
+
+        if((rendered == TRUE) && (lat_pending == TRUE)){
+            lat_pending = FALSE;
+            waveLatRecord(first, lat_cycles, lat_ticks);
+        }else{}
+    }
+}
+
+/*
+ * waveRerender()
+ * Private Function
+ *
+ * Renders wave from WAVE_SAFE_SAMPLES past the DMA's next sample to the
+ * end of the queued block. The boundary is picked from the live CITER:
+ * - In the playing block, its tail is rendered again and then the
+ *   queued block, if it has been rendered yet.
+ * - Past the end of the playing block, only the queued block from it.
+ * The renderer is ~30 times faster than the DMA, so once the first
+ * sample is written ahead of it the rest stay ahead.
+ * The state at the boundary comes from waveSegState(), so the phase
+ * and gain carry on from what has already played.
+ * Nothing is done while the block done interrupt for the playing block
+ * is still outstanding, the coming block render uses the new wave.
+ * Returns TRUE if anything was rendered, with the index of the first
+ * new sample in *first.
+ */
+static INT8U waveRerender(const WAVE_W *wave, INT8U *first){
+    INT8U next = DMANextSample();
+    INT8U playing = next/DMA_64SAMPLES_PERBLOCK;
+    INT8U boundary = (next + WAVE_SAFE_SAMPLES) & (WAVE_BUF_SAMPLES - 1);
+    INT8U block = boundary/DMA_64SAMPLES_PERBLOCK;
+    INT8U offset = boundary & (DMA_64SAMPLES_PERBLOCK - 1);
+    INT8U done = FALSE;
+    WAVE_RENDER state;
+
+    if(DMABlockReady() == playing){             // Its start not serviced yet
+    }else if(block == playing){
+        waveSegState(block, offset, &state);
+        waveRenderSeg(block, offset, &state, wave);
+        if(waveQueued != playing){              // Queued block rendered, carry on into it
+            waveRenderSeg(waveQueued, 0, &waveEnd, wave);
+        }else{}                                 // else its block done renders it from waveEnd
+        done = TRUE;
+    }else if(waveQueued == block){              // Boundary already in the queued block
+        waveSegState(block, offset, &state);
+        waveRenderSeg(block, offset, &state, wave);
+        done = TRUE;
+    }else{}
+
+    if(done == TRUE){
+        *first = boundary;
+        // The DMA passed the boundary if it is now further away than before
+        if(((boundary - DMANextSample()) & (WAVE_BUF_SAMPLES - 1)) > WAVE_SAFE_SAMPLES){
+            waveLateRenders++;
+        }else{}
+    }else{}
+    return done;
+}
+
+/*
+ * waveRenderSeg()
+ * Private Function
+ *
+ * Renders wave into block from sample from to its end, starting from
+ * start, and records it in waveSeg[]. Leaves the end state in waveEnd.
+ */
+static void waveRenderSeg(INT8U block, INT8U from, const WAVE_RENDER *start, const WAVE_W *wave){
+    WAVE_SEG *seg = &waveSeg[block];
+
+    seg->from = from;
+    seg->start = *start;
+    seg->wave = *wave;
+    waveEnd = *start;
+    waveRender(&wavCurSamples[block][from], DMA_64SAMPLES_PERBLOCK - from, wave, &waveEnd);
+}
+
+/*
+ * waveSegState()
+ * Private Function
+ *
+ * Renderer state just before sample offset of block, from its waveSeg[]
+ * entry: the phase steps at the segment's frequency and the gain is on
+ * the segment's ramp. The boundary only moves forward within a block,
+ * so offset is never before the segment's start.
+ */
+static void waveSegState(INT8U block, INT8U offset, WAVE_RENDER *state){
+    const WAVE_SEG *seg = &waveSeg[block];
+    INT32U done = (INT32U)(offset - seg->from);
+    INT32S count = DMA_64SAMPLES_PERBLOCK - seg->from;
+    INT8U amp = seg->wave.amp;
+    INT32S target;
+
+    if(amp > WAVE_AMP_MAX){
+        amp = WAVE_AMP_MAX;
+    }else{}
+    target = WAVE_GAIN_Q15(amp);
+    state->phase = seg->start.phase + (done*(INT32U)seg->wave.freq*WAVE_PHASE_PER_HZ);
+    state->gain_q15 = seg->start.gain_q15 + (((target - seg->start.gain_q15)*(INT32S)done)/count);
+}
+
+/*
+ * WaveRenderBlock()
+ * Public Function
+ *
+ * Renders one DMA block of samples for the passed wave into block.
+ * render carries the phase and the gain from one block to the next and
+ * must be kept by the caller.
+ *
+ * Split out of ProcessTask so it can be timed on its own by WaveBench.
+ */
+void WaveRenderBlock(INT16U *block, const WAVE_W *wave, WAVE_RENDER *render){
+    waveRender(block, DMA_64SAMPLES_PERBLOCK, wave, render);
+}
+
+/*
+ * waveRender()
+ * Private Function
+ *
+ * Renders count samples into dest. The shapes are rendered at full
+ * scale and waveGainRamp() scales them, so an amplitude change is a
+ * ramp and not a step.
+ */
+static void waveRender(INT16U *dest, INT16U count, const WAVE_W *wave, WAVE_RENDER *render){
+    INT16U sample_index;
+    INT16U wave_amp = wave->amp;
+    INT32U phase = render->phase;
+    INT32U phase_step = (INT32U)wave->freq*WAVE_PHASE_PER_HZ;
+    INT32S tri;
+    q31_t sin_sample;
+
+    if(wave_amp > WAVE_AMP_MAX){
+        wave_amp = WAVE_AMP_MAX;
+    }else{}
+    sample_index = 0;
+    switch(wave->waveshape){
+        case TRI:
+            while(sample_index < count){
+                tri = (INT32S)(phase>>16);      // 0-65535 over the period
+                if(tri < 32768){                // Rising from ramp min
+                    tri = (tri*2) - 32768;
+                }else{                          // Falling from ramp max
+                    tri = 32767 - ((tri - 32768)*2);
+                }
+                dest[sample_index] = (INT16U)(WAVE_MID + ((tri*WAVE_PEAK)>>15));
+                sample_index++;
+                phase += phase_step;
+            }
+            break;
+        case SIN:
+            while(sample_index < count){
+                sin_sample = arm_sin_q31((q31_t)(phase>>1));    // [0, 2^31) is one period
+                dest[sample_index] = (INT16U)(WAVE_MID + (((sin_sample>>16)*WAVE_PEAK)>>15));
+                sample_index++;
+                phase += phase_step;
+            }
+            break;
+
+        default:
+            break;
+    }
+    render->phase = phase;
+    waveGainRamp(dest, count, render, WAVE_GAIN_Q15(wave_amp));
+}
+
+/*
+ * waveGainRamp()
+ * Private Function
+ *
+ * Scales count full scale samples around WAVE_MID, stepping the gain
+ * evenly from render->gain_q15 to target_q15 so the last sample is at
+ * the target. Offsets are within +-WAVE_PEAK so the product fits 32 bits.
+ */
+static void waveGainRamp(INT16U *dest, INT16U count, WAVE_RENDER *render, INT32S target_q15){
+    INT16U sample_index;
+    INT32S gain = render->gain_q15;
+    INT32S step = (target_q15 - gain)/(INT32S)count;
+    INT32S offset;
+
+    for(sample_index = 0; sample_index < count; sample_index++){
+        if(sample_index == (count - 1)){
+            gain = target_q15;          // Absorbs the rounding of step
+        }else{
+            gain += step;
+        }
+        offset = (INT32S)dest[sample_index] - WAVE_MID;
+        dest[sample_index] = (INT16U)(WAVE_MID + ((offset*gain)>>15));
+    }
+    render->gain_q15 = target_q15;
+}
+
+/*
+ * waveLatRecord()
+ * Private Function
+ *
+ * Latency of a timed change rendered from sample first: key press to
+ * set in ticks, set to now in core cycles, and the samples the DMA
+ * outputs before it reaches first. Called right after the render.
+ */
+static void waveLatRecord(INT8U first, INT32U set_cycles, OS_TICK key_ticks){
+    OS_ERR os_err;
+    INT32U cycles;
+    INT32U us;
+
+    cycles = (CYCLE_CNT_GET() - set_cycles) + ((INT32U)((first - DMANextSample()) & (WAVE_BUF_SAMPLES - 1))*WAVE_CYCLES_PER_SAMPLE);
+    us = (key_ticks*(1000000U/OSCfg_TickRate_Hz)) + (cycles/WAVE_CYCLES_PER_US);
+
+    OSMutexPend(&WaveMutexKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
+    waveLatLastUs = us;
+    if(us > waveLatMaxUs){
+        waveLatMaxUs = us;
+    }else{}
+    OSMutexPost(&WaveMutexKey, OS_OPT_POST_NONE, &os_err);
+
+#if (APP_CFG_TRACE_EN == DEF_ENABLED)
+    if(us > 0xFFFFU){
+        us = 0xFFFFU;
+    }else{}
+    TraceEvent(TRACE_ID_WAVE_LAT, 0, (INT16U)us);
+#endif
+}
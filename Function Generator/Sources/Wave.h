@@ -1,72 +1,124 @@
-/*
- * Wave.c
- *  Source File for the Wave generator module.
- *
- *
- *  Created on: Feb 9, 2018
- *      Author: Mesecar
- */
-
-#ifndef SOURCES_WAVE_H_
-#define SOURCES_WAVE_H_
-
-typedef enum {TRI, SIN} WAVE_TYPE;
-
-typedef struct{
-    INT16U freq;
-    INT8U amp;
-    WAVE_TYPE waveshape;
-} WAVE_W;
-
-/*
- * WaveInit()
- * Public Function
- *
- * Initializes the Wave module:
- *
- * ~Rod Mesecar, 2/9/18
- */
-void WaveInit(void);
-
-/*
- * WaveGet()
- * Public Function
- *
- * When Called, pends on WaveMutexKey and copies the contents of
- * CurrentSignal to the address of the passed pointer.
- *
- * ~Rod Mesecar, 2/9/18
- */
-void WaveGet(WAVE_W *passwave);
-
-
-/*
- * WaveSet()
- * Public Function
- *
- * When Called, pends on WaveMutexKey and copies the contents at
- * the address of the passed pointer to CurrentSignal
- *
- * ~Rod Mesecar, 2/9/18
- */
-void WaveSet(WAVE_W *passwave);
-
-
-/*
- * WaveUpdateIndex()
- * Public Function
- *
- * When called, copies the DMABufferIndex to the passed value to the  and posts the BufferDoneFlag
- *
- * ~Rod Mesecar, 2/10/18
- *
- *  UPDATE: Now copies DMABufferIndex to the pointer, was copies passed values to DMABufferIndex
- *  Header updated to match new function
- *
- *  ~Rod Mesecar 2/13/18
- *
- */
-void WaveUpdateIndex (INT8U *blockIndex);
-
-
-#endif /* SOURCES_WAVE_H_ */
+/*
+ * Wave.c
+ *  Source File for the Wave generator module.
+ *
+ *
+ *  Created on: Feb 9, 2018
+ *      Author: Mesecar
+ */
+
+#ifndef SOURCES_WAVE_H_
+#define SOURCES_WAVE_H_
+
+typedef enum {TRI, SIN} WAVE_TYPE;
+
+#define WAVE_AMP_MAX 20                 // Full scale amp, larger values are clamped
+#define WAVE_GAIN_Q15(amp) ((((INT32S)(amp)) << 15) / WAVE_AMP_MAX)
+
+typedef struct{
+    INT16U freq;
+    INT8U amp;
+    WAVE_TYPE waveshape;
+} WAVE_W;
+
+/*
+ * Renderer state carried from one block to the next
+ */
+typedef struct{
+    INT32U phase;                       // Phase accumulator, 2^32 is one period
+    INT32S gain_q15;                    // Gain reached at the end of the last block
+} WAVE_RENDER;
+
+/*
+ * WaveInit()
+ * Public Function
+ *
+ * Initializes the Wave module:
+ *
+ * ~Rod Mesecar, 2/9/18
+ */
+void WaveInit(void);
+
+/*
+ * WaveGet()
+ * Public Function
+ *
+ * When Called, pends on WaveMutexKey and copies the contents of
+ * CurrentSignal to the address of the passed pointer.
+ *
+ * ~Rod Mesecar, 2/9/18
+ */
+void WaveGet(WAVE_W *passwave);
+
+
+/*
+ * WaveSet()
+ * Public Function
+ *
+ * When Called, pends on WaveMutexKey and copies the contents at
+ * the address of the passed pointer to CurrentSignal
+ *
+ * ~Rod Mesecar, 2/9/18
+ */
+void WaveSet(WAVE_W *passwave);
+
+/*
+ * WaveSetAmp()
+ * Public Function
+ *
+ * Changes only the amplitude of CurrentSignal, clamped to WAVE_AMP_MAX.
+ * The renderer ramps to it over the next block, so it can be called
+ * while the amplitude is being swept without clicks at block edges.
+ */
+void WaveSetAmp(INT8U amp);
+
+/*
+ * WaveSetLive()
+ * Public Function
+ *
+ * WaveSet() for a change made from a key press at key_time, the tick in
+ * its KEY_EVENT. The time from key_time to the first DAC sample of the
+ * new wave is measured, see WaveLatencyGet().
+ */
+void WaveSetLive(WAVE_W *passwave, OS_TICK key_time);
+
+/*
+ * WaveLatencyGet()
+ * Public Function
+ *
+ * Key to DAC latency of the last WaveSetLive() that reached the output
+ * and the longest so far, in microseconds.
+ */
+void WaveLatencyGet(INT32U *last_us, INT32U *max_us);
+
+
+/*
+ * WaveUpdateIndex()
+ * Public Function
+ *
+ * When called, copies the DMABufferIndex to the passed value to the  and posts the BufferDoneFlag
+ *
+ * ~Rod Mesecar, 2/10/18
+ *
+ *  UPDATE: Now copies DMABufferIndex to the pointer, was copies passed values to DMABufferIndex
+ *  Header updated to match new function
+ *
+ *  ~Rod Mesecar 2/13/18
+ *
+ */
+void WaveUpdateIndex (INT8U *blockIndex);
+
+/*
+ * WaveRenderBlock()
+ * Public Function
+ *
+ * Renders one DMA block of samples for the passed wave into block.
+ * render carries the phase and the gain from one block to the next and
+ * must be kept by the caller. The gain ramps linearly across the block
+ * from render->gain_q15 to the wave's amp. Only the phase step depends
+ * on the frequency, so a new frequency continues from the same phase.
+ */
+void WaveRenderBlock(INT16U *block, const WAVE_W *wave, WAVE_RENDER *render);
+
+
+#endif /* SOURCES_WAVE_H_ */
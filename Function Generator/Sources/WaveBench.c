@@ -0,0 +1,105 @@
+/*******************************************************************************
+* WaveBench.c - Render benchmark for the Wave module. Times every waveshape's
+*               block render with the DWT cycle counter so a change in Wave.c
+*               that makes ProcessTask slower is caught at startup instead of
+*               on the scope with DB0.
+*
+*               Enabled with APP_CFG_WAVE_BENCH_EN in app_cfg.h.
+*******************************************************************************/
+#include "MCUType.h"
+#include "app_cfg.h"
+#include "os.h"
+#include "Wave.h"
+#include "DMA.h"
+#include "CycleCnt.h"
+#include "WaveBench.h"
+
+#define WAVE_BENCH_NUM_FREQS 4
+
+static const INT16U waveBenchFreqs[WAVE_BENCH_NUM_FREQS] = {10, 100, 1000, 10000};
+static const INT32U waveBenchLimits[WAVE_BENCH_NUM_SHAPES] = {WAVE_BENCH_TRI_LIMIT,
+                                                              WAVE_BENCH_SIN_LIMIT};
+
+static WAVE_BENCH_RESULT waveBenchResults[WAVE_BENCH_NUM_SHAPES];
+static INT16U waveBenchBlock[DMA_64SAMPLES_PERBLOCK];
+
+/********************************************************************
+* WaveBenchRun - Times WaveRenderBlock() for every waveshape
+*
+* Description:  The counter is read immediately around the call so the
+*               figures include the call overhead ProcessTask also pays.
+*               Interrupts are left enabled, so the max includes any ISR
+*               running at startup that landed in a block, as it would
+*               in use. The DMA interrupt is not running yet, see
+*               WaveBench.h.
+*
+* Return value: TRUE if every shape is within its limit, else FALSE
+*
+* Arguments:    None
+********************************************************************/
+INT8U WaveBenchRun(void){
+    WAVE_W wave;
+    WAVE_BENCH_RESULT *result;
+    WAVE_RENDER render;
+    INT32U start;
+    INT32U cycles;
+    INT32U total;
+    INT8U shape;
+    INT8U freq_index;
+    INT8U block;
+    INT8U all_pass = TRUE;
+
+    CycleCntInit();
+    wave.amp = 20;
+
+    for(shape = 0; shape < WAVE_BENCH_NUM_SHAPES; shape++){
+        result = &waveBenchResults[shape];
+        result->blk_min = 0xFFFFFFFFU;
+        result->blk_max = 0;
+        result->limit = waveBenchLimits[shape];
+        total = 0;
+        wave.waveshape = (WAVE_TYPE)shape;
+
+        for(freq_index = 0; freq_index < WAVE_BENCH_NUM_FREQS; freq_index++){
+            wave.freq = waveBenchFreqs[freq_index];
+            render.phase = 0;
+            render.gain_q15 = WAVE_GAIN_Q15(wave.amp);
+            for(block = 0; block < WAVE_BENCH_BLOCKS; block++){
+                start = CYCLE_CNT_GET();
+                WaveRenderBlock(waveBenchBlock, &wave, &render);
+                cycles = CYCLE_CNT_GET() - start;
+
+                total += cycles;
+                if(cycles < result->blk_min){
+                    result->blk_min = cycles;
+                }else{}
+                if(cycles > result->blk_max){
+                    result->blk_max = cycles;
+                }else{}
+            }
+        }
+
+        result->blk_mean = total/(WAVE_BENCH_NUM_FREQS*WAVE_BENCH_BLOCKS);
+        result->smp_min = result->blk_min/DMA_64SAMPLES_PERBLOCK;
+        result->smp_mean = result->blk_mean/DMA_64SAMPLES_PERBLOCK;
+        result->smp_max = result->blk_max/DMA_64SAMPLES_PERBLOCK;
+        if(result->blk_max <= result->limit){
+            result->pass = TRUE;
+        }else{
+            result->pass = FALSE;
+            all_pass = FALSE;
+        }
+    }
+    return all_pass;
+}
+
+/********************************************************************
+* WaveBenchGet - Returns the result of the last WaveBenchRun()
+*
+* Return value: Pointer to the result for shape
+*
+* Arguments:    shape - TRI or SIN
+********************************************************************/
+const WAVE_BENCH_RESULT *WaveBenchGet(WAVE_TYPE shape){
+    return &waveBenchResults[shape];
+}
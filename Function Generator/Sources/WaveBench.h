@@ -0,0 +1,53 @@
+/*******************************************************************************
+* WaveBench.h - Project header file for WaveBench.c
+*
+* Cycle counts are core clock cycles read from the DWT cycle counter.
+*******************************************************************************/
+#ifndef SOURCES_WAVEBENCH_H_
+#define SOURCES_WAVEBENCH_H_
+
+#define WAVE_BENCH_NUM_SHAPES 2
+#define WAVE_BENCH_BLOCKS 32            //Blocks rendered per frequency tested
+
+// Worst case cycles allowed for one block before WaveBenchRun() fails
+#define WAVE_BENCH_TRI_LIMIT 4000U
+#define WAVE_BENCH_SIN_LIMIT 8000U
+
+typedef struct{
+    INT32U blk_min;                     //Cycles per block
+    INT32U blk_mean;
+    INT32U blk_max;
+    INT32U smp_min;                     //Cycles per sample
+    INT32U smp_mean;
+    INT32U smp_max;
+    INT32U limit;                       //Limit blk_max was checked against
+    INT8U pass;
+} WAVE_BENCH_RESULT;
+
+/********************************************************************
+* WaveBenchRun - Times WaveRenderBlock() for every waveshape
+*
+* Description:  Renders WAVE_BENCH_BLOCKS blocks into a scratch buffer
+*               at each test frequency for every shape and records the
+*               min/mean/max cycles. Must be called before DMAInit()
+*               and WaveInit() so the DMA interrupt and ProcessTask are
+*               not running yet. Interrupts are not masked, so the
+*               limits include any tick, keypad, TSI or LCD ISR that
+*               lands in a timed block.
+*
+* Return value: TRUE if every shape is within its limit, else FALSE
+*
+* Arguments:    None
+********************************************************************/
+INT8U WaveBenchRun(void);
+
+/********************************************************************
+* WaveBenchGet - Returns the result of the last WaveBenchRun()
+*
+* Return value: Pointer to the result for shape
+*
+* Arguments:    shape - TRI or SIN
+********************************************************************/
+const WAVE_BENCH_RESULT *WaveBenchGet(WAVE_TYPE shape);
+
+#endif /* SOURCES_WAVEBENCH_H_ */
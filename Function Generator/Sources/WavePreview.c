@@ -0,0 +1,77 @@
+/*******************************************************************************
+* WavePreview.c - Miniature waveform on the character LCD. One period of the
+*                 current shape, scaled by amplitude, is drawn one pixel per
+*                 column into custom CG RAM glyphs.
+*******************************************************************************/
+#include "MCUType.h"
+#include "app_cfg.h"
+#include "os.h"
+#include "LcdLayered.h"
+#include "Wave.h"
+#include "WavePreview.h"
+
+#define WAVE_PREVIEW_WIDTH (WAVE_PREVIEW_CELLS*5)
+#define WAVE_PREVIEW_AMP_MAX 20
+
+/* One period sampled at the centre of each pixel column, +-64 full scale.
+ * TRI matches Wave.c, rising from the minimum for the first half period.   */
+static const INT8S wavePreviewSin[WAVE_PREVIEW_WIDTH] =
+    {13, 38, 55, 64, 61, 48, 26, 0, -26, -48, -61, -64, -55, -38, -13};
+static const INT8S wavePreviewTri[WAVE_PREVIEW_WIDTH] =
+    {-55, -38, -21, -4, 13, 30, 47, 64, 47, 30, 13, -4, -21, -38, -55};
+
+static WAVE_TYPE wavePreviewShape;
+static INT8U wavePreviewAmp;
+static INT8U wavePreviewValid = FALSE;
+
+/********************************************************************
+* WavePreviewDisp - Shows one period of the wave across
+*                   WAVE_PREVIEW_CELLS characters
+*
+* Description:  Pixel row for a column is 7*(1280 - v*amp)/2560 rounded,
+*               0 at the top, so full amplitude spans rows 0-7 and zero
+*               amplitude is a flat line.
+********************************************************************/
+void WavePreviewDisp(INT8U row, INT8U col, INT8U layer, const WAVE_W *wave){
+    INT8U glyphs[WAVE_PREVIEW_CELLS][LCD_GLYPH_ROWS];
+    INT8C chars[WAVE_PREVIEW_CELLS+1];
+    const INT8S *table;
+    INT32S v;
+    INT8U amp = wave->amp;
+    INT8U x;
+    INT8U y;
+    INT8U cell;
+
+    if(amp > WAVE_PREVIEW_AMP_MAX){
+        amp = WAVE_PREVIEW_AMP_MAX;
+    }else{}
+
+    if((wavePreviewValid == FALSE) || (wave->waveshape != wavePreviewShape) ||
+       (amp != wavePreviewAmp)){
+        wavePreviewValid = TRUE;
+        wavePreviewShape = wave->waveshape;
+        wavePreviewAmp = amp;
+
+        if(wave->waveshape == SIN){
+            table = wavePreviewSin;
+        }else{
+            table = wavePreviewTri;
+        }
+        for(cell = 0; cell < WAVE_PREVIEW_CELLS; cell++){
+            for(y = 0; y < LCD_GLYPH_ROWS; y++){
+                glyphs[cell][y] = 0;
+            }
+        }
+        for(x = 0; x < WAVE_PREVIEW_WIDTH; x++){
+            v = (INT32S)table[x] * amp;
+            y = (INT8U)(((7 * (1280 - v)) + 1280) / 2560);
+            glyphs[x/5][y] |= (INT8U)(0x10 >> (x%5));
+        }
+        for(cell = 0; cell < WAVE_PREVIEW_CELLS; cell++){
+            (void)LcdGlyphSet(WAVE_PREVIEW_GLYPH + cell, glyphs[cell]);
+            chars[cell] = LCD_GLYPH_CHAR(WAVE_PREVIEW_GLYPH + cell);
+        }
+        chars[WAVE_PREVIEW_CELLS] = 0;
+        LcdDispString(row, col, layer, chars);
+    }else{}
+}
@@ -0,0 +1,30 @@
+/*******************************************************************************
+* WavePreview.h - Project header file for WavePreview.c
+*******************************************************************************/
+#ifndef SOURCES_WAVEPREVIEW_H_
+#define SOURCES_WAVEPREVIEW_H_
+
+#define WAVE_PREVIEW_CELLS 3            //Characters wide, 5 pixels each
+#define WAVE_PREVIEW_GLYPH 0            //First of the CG RAM glyphs used
+
+/********************************************************************
+* WavePreviewDisp - Shows one period of the wave across
+*                   WAVE_PREVIEW_CELLS characters
+*
+* Description:  The glyphs are only redrawn when the shape or amplitude
+*               differ from the last call, and LcdGlyphSet() only
+*               rewrites the CG RAM rows that changed, so calling this
+*               on every UI update costs no LCD writes while the output
+*               is steady. The characters are written along with the
+*               glyphs, so the layer must not be cleared in between.
+*               Frequency is not shown.
+*
+* Return value: None
+*
+* Arguments:    row, col, layer - Where to show the preview, as for
+*                                 LcdDispString()
+*               wave            - Wave to preview
+********************************************************************/
+void WavePreviewDisp(INT8U row, INT8U col, INT8U layer, const WAVE_W *wave);
+
+#endif /* SOURCES_WAVEPREVIEW_H_ */
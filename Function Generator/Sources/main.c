@@ -1,300 +1,548 @@
-/*****************************************************************************************
-* main.c - uC/OS program that outputs a voltage waveform, configurable by user.
-*
-* 02/01/2018, Brian Willis
-* 2/7/18, Rod Mesecar Added to Project
-* 2/7/18, Anthony Needles Added to Project
-*
-*****************************************************************************************/
-#include "MCUType.h"
-#include "app_cfg.h"
-#include "os.h"
-#include "K65TWR_GPIO.h"
-#include "uCOSKey.h"
+/*****************************************************************************************
+* main.c - uC/OS program that outputs a voltage waveform, configurable by user.
+*
+* 02/01/2018, Brian Willis
+* 2/7/18, Rod Mesecar Added to Project
+* 2/7/18, Anthony Needles Added to Project
+*
+*****************************************************************************************/
+#include "MCUType.h"
+#include "app_cfg.h"
+#include "os.h"
+#include "K65TWR_GPIO.h"
+#include "uCOSKey.h"
 #include "LcdLayered.h"
 #include "DMA.h"
-#include "TSI.h"
-#include "Wave.h"
-
-
-/*****************************************************************************************
-* Defined Constants
-*****************************************************************************************/
-#define CURSORSTART 10
-#define UI_TASK_MSG_Q_SIZE 5
-
-/*****************************************************************************************
-* Allocate task control blocks
-*****************************************************************************************/
-static OS_TCB AppTaskStartTCB;
-static OS_TCB UITaskTCB;
-static OS_TCB UITSISrvTaskTCB;
-static OS_TCB UIKeySrvTaskTCB;
-
-
-/*****************************************************************************************
-* Allocate task stack space
-*****************************************************************************************/
-static CPU_STK AppTaskStartStk[APP_CFG_TASK_START_STK_SIZE];
-static CPU_STK UITaskStk[APP_CFG_UITASK_STK_SIZE];
-static CPU_STK UITSISrvTaskStk[APP_CFG_UITSISRV_TASK_STK_SIZE];
-static CPU_STK UIKeySrvTaskStk[APP_CFG_UIKEYSRV_TASK_STK_SIZE];
-
-/*****************************************************************************************
-* Task Function Prototypes
-*****************************************************************************************/
-static void AppStartTask(void *p_arg);
-static void UITask(void *p_arg);
-static void UITSISrvTask(void *p_arg);
-static void UIKeySrvTask(void *p_arg);
-
-/*****************************************************************************************
-* Private resources
-*****************************************************************************************/
-static WAVE_W dispWave;         //Local wave that displays waveform from Wave.c
-static WAVE_W setWave;          //Local wave that gets adjusted by UI Task
+#include "TSI.h"
+#include "Wave.h"
+#include "WaveBench.h"
+#include "Trace.h"
+#include "Diag.h"
+#include "WavePreview.h"
+#include "os_app_hooks.h"
+#include "CycleCnt.h"
+#include "Preset.h"
+#include "Scpi.h"
+#include "Fmt.h"
+
+
+/*****************************************************************************************
+* Defined Constants
+*****************************************************************************************/
+#define CURSORSTART 10
+#define UI_FLAG_KEY    ((OS_FLAGS)0x01u)  //uiInputFlags: key event queued
+#define UI_FLAG_TOUCH  ((OS_FLAGS)0x02u)  //uiInputFlags: touch posted
+#define UI_FLAG_REMOTE ((OS_FLAGS)0x04u)  //uiInputFlags: serial command changed the wave
+#define UI_MAX_DIGITS 5
+#define UI_NOT_SHOWN 0xFFFFFFFFU        //Field value before the first draw
+
+/*****************************************************************************************
+* Allocate task control blocks
+*****************************************************************************************/
+static OS_TCB AppTaskStartTCB;
+static OS_TCB UITaskTCB;
+
+
+/*****************************************************************************************
+* Allocate task stack space
+*****************************************************************************************/
+static CPU_STK AppTaskStartStk[APP_CFG_TASK_START_STK_SIZE];
+static CPU_STK UITaskStk[APP_CFG_UITASK_STK_SIZE];
+
+/*****************************************************************************************
+* Task Function Prototypes
+*****************************************************************************************/
+static void AppStartTask(void *p_arg);
+static void UITask(void *p_arg);
+
+/*****************************************************************************************
+* Input - the keypad and touch modules set a flag here with every event they queue so
+* UITask waits on both at once and then takes the events by value from each module.
+* Scpi.c sets a flag when a serial command changes the wave so the display follows it.
+*****************************************************************************************/
+static OS_FLAG_GRP uiInputFlags;
+static void uiHandleKey(INT8U key, OS_TICK time);
+static void uiHandleLong(INT8U key, OS_TICK time);
+static void uiHandleRelease(INT8U key, OS_TICK time);
+static INT8U uiHandleRepeat(INT8U key);
+
+/*****************************************************************************************
+* Touch amplitude gesture - left raises and right lowers the amplitude one step per touch.
+* Held, it keeps stepping, faster the longer it is held, until it is lifted or the
+* amplitude saturates. Each step goes straight to WaveSetAmp(), '#' is not needed.
+*****************************************************************************************/
+static INT8U uiTouchElec = 0;          //Electrode being held, 0 if no gesture
+static INT8U uiTouchSteps;             //Steps since it started to run
+static OS_TICK uiTouchDue;             //Tick of the next step
+static void uiTouchStart(INT8U touch);
+static void uiTouchRun(void);
+static OS_TICK uiTouchWait(void);
+static void uiAmpStep(INT8U touch);
+
+/*****************************************************************************************
+* Retained UI fields - each field keeps the value last written to the layer and is only
+* formatted and written again when the value changes.
+*****************************************************************************************/
+typedef struct{
+    INT8U row;
+    INT8U col;
+    INT8U digits;
+    INT32U shown;
+} UI_NUM_FIELD;
+
+static void uiNumFieldUpdate(UI_NUM_FIELD *field, INT32U value);
+
+/*****************************************************************************************
+* Private resources
+*****************************************************************************************/
+static WAVE_W dispWave;         //Local wave that displays waveform from Wave.c
+static WAVE_W setWave;          //Local wave that gets adjusted by UI Task
 static INT8U cursorLoc = CURSORSTART;
-
-/*****************************************************************************************
-* main()
-*****************************************************************************************/
-void main(void){
-    OS_ERR os_err;
-    CPU_IntDis();                                               //Disable all interrupts, OS will enable them
-    OSInit(&os_err);                                            //Initialize uC/OS-III
-    while(os_err != OS_ERR_NONE){}                              //Error Trap
-
-    OSTaskCreate(&AppTaskStartTCB,                              //Address of TCB assigned to task
-                 "Start Task",                                  //Name you want to give the task
-                 AppStartTask,                                  //Address of the task itself
-                 (void *) 0,                                    //p_arg is not used so null ptr
-                 APP_CFG_TASK_START_PRIO,                       //Priority you assign to the task
-                 &AppTaskStartStk[0],                           //Base address of tasks stack
-                 (APP_CFG_TASK_START_STK_SIZE/10u),             //Watermark limit for stack growth
-                 APP_CFG_TASK_START_STK_SIZE,                   //Stack size
-                 0,                                             //Size of task message queue
-                 0,                                             //Time quanta for round robin
-                 (void *) 0,                                    //Extension pointer is not used
-                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR),   //Options
-                 &os_err);                                      //Ptr to error code destination
-    while(os_err != OS_ERR_NONE){}                              //Error Trap
-
-    OSStart(&os_err);                                           //Start multitasking (i.e. give control to uC/OS)
-    while(os_err != OS_ERR_NONE){}                              //Error Trap
-}
-
-/*****************************************************************************************
-* This should run once and be suspended. Could restart everything by resuming.
-* (Resuming not tested)
-* Todd Morton, 01/06/2016
-* Modified for Lab 3: Brian Willis, 02/14/2018
-*****************************************************************************************/
-static void AppStartTask(void *p_arg) {
-    OS_ERR os_err;
-    (void)p_arg;                                //Avoid compiler warning for unused variable
-    OS_CPU_SysTickInitFreq(DEFAULT_SYSTEM_CLOCK);
-
-    /* Initialize StatTask. This must be called when there is only one task running.
-     * Therefore, any function call that creates a new task must come after this line.
-     * Or, alternatively, you can comment out this line, or remove it. If you do, you
-     * will not have accurate CPU load information                                       */
-    OSStatTaskCPUUsageInit(&os_err);
-
-    //Initialize peripherals
-    LcdInit();
-    KeyInit();
-    TSIInit();
-    GpioDBugBitsInit();
-    DMAInit(*wavCurSamples);
-    DMADAC0Init();
-    DMAPIT0Init();
-    WaveInit();
-
-    WaveGet(&setWave);
-    WaveGet(&dispWave);                          //Initialize local wave
-    LcdDispClear(WAVE_LAYER);
-
-    OSTaskCreate(&UITaskTCB,                    //Create UITask
-                 "UI Task",
-                 UITask,
-                 (void *) 0,
-                 APP_CFG_UI_TASK_PRIO,
-                 &UITaskStk[0],
-                 (APP_CFG_UI_TASK_STK_SIZE / 10u),
-                 APP_CFG_UI_TASK_STK_SIZE,
-				 UI_TASK_MSG_Q_SIZE, // Task Msg Queue
-                 0,
-                 (void *) 0,
-                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR),
-                 &os_err);
-   while(os_err != OS_ERR_NONE){}              //Error Trap
-
-   OSTaskCreate(&UITSISrvTaskTCB,              //Create UITSISrvTask
-                   "UI Touch Service Task",
-				   UITSISrvTask,
-                   (void *) 0,
-                   APP_CFG_UITSISRV_TASK_PRIO,
-                   &UITSISrvTaskStk[0],
-                   (APP_CFG_UITSISRV_TASK_STK_SIZE / 10u),
-                   APP_CFG_UITSISRV_TASK_STK_SIZE,
-                   0,
-                   0,
-                   (void *) 0,
-                   (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR),
-                   &os_err);
-    while(os_err != OS_ERR_NONE){}              //Error Trap
-
-    OSTaskCreate(&UIKeySrvTaskTCB,              //Create UITSISrvTask
-                 "UI Key Service Task",
-                 UIKeySrvTask,
-                 (void *) 0,
-                 APP_CFG_UIKEYSRV_TASK_PRIO,
-                 &UIKeySrvTaskStk[0],
-                 (APP_CFG_UIKEYSRV_TASK_STK_SIZE / 10u),
-                 APP_CFG_UIKEYSRV_TASK_STK_SIZE,
-                 0,
-                 0,
-                 (void *) 0,
-                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR),
-                 &os_err);
-    while(os_err != OS_ERR_NONE){}              //Error Trap
-
-    OSTaskSuspend((OS_TCB *)0, &os_err);
-    while(os_err != OS_ERR_NONE){}              //Error Trap
-}
-
-/*****************************************************************************************
-* UITask() - Controls the user interface
-*****************************************************************************************/
-static void UITask(void *p_arg){
-    OS_ERR os_err;
-    INT8U *msgp;
-    OS_MSG_SIZE msg_size;
-    (void)p_arg;
-
-    while(1){
-        (void)LcdCursor(2, cursorLoc, WAVE_LAYER, TRUE, TRUE);  //Display cursor
-
-        //Display current waveform to LCD
-        LcdDispDecByte(1, 2, WAVE_LAYER, dispWave.amp, 1);
-        LcdDispString(1, 1, WAVE_LAYER, "A:");
-        LcdDispDecByte(1, CURSORSTART+2, WAVE_LAYER, (INT8U)(dispWave.freq-((dispWave.freq/100)*100)), 1);          //Display lower 2 chars of frequency
-        LcdDispDecByte(1, CURSORSTART, WAVE_LAYER, (INT8U)(((dispWave.freq-((dispWave.freq/10000)*10000))
-                                                            -(dispWave.freq-((dispWave.freq/100)*100)))/100), 1);   //Middle 2 chars
-        LcdDispDecByte(1, CURSORSTART-2, WAVE_LAYER, (INT8U)((dispWave.freq)/10000), 1);                            //Upper char
-        LcdDispString(1, 8, WAVE_LAYER, "F:");
-        LcdDispString(1, 15, WAVE_LAYER, "Hz");
-        if(dispWave.waveshape == SIN){
-            LcdDispString(2, 1, WAVE_LAYER, "SINE");
-        } else{
-            LcdDispString(2, 1, WAVE_LAYER, "TRI ");
-        }
-
-        //Display updating frequency to LCD
-        LcdDispDecByte(2, CURSORSTART+2, WAVE_LAYER, (INT8U)(setWave.freq-((setWave.freq/100)*100)), 1);
-        LcdDispDecByte(2, CURSORSTART, WAVE_LAYER, (INT8U)(((setWave.freq-((setWave.freq/10000)*10000))
-                                                            -(setWave.freq-((setWave.freq/100)*100)))/100), 1);
-        LcdDispDecByte(2, CURSORSTART-2, WAVE_LAYER, (INT8U)((setWave.freq)/10000), 1);
-        LcdDispString(2, 8, WAVE_LAYER, "F:");
-        LcdDispString(2, 15, WAVE_LAYER, "Hz");
-
-        DB0_TURN_OFF();                                                                 //Turn off debug bit while waiting
-        msgp = OSTaskQPend(0, OS_OPT_PEND_BLOCKING, &msg_size, (CPU_TS *)0, &os_err);   //Wait for either key press or TSI
-        while(os_err != OS_ERR_NONE){}                                                  //Error Trap
-        DB0_TURN_ON();                                                                  //Turn on debug bit while ready/running
-
-        switch(*msgp){
-            case(1):                //Left electrode touched
-                setWave.amp++;
-                break;
-            case(2):                //Right electrode touched
-                setWave.amp--;
-                break;
-            default:                //Key press
-                if(*msgp == 0x11){                          //'A'
-                    setWave.waveshape = SIN;
-                } else if(*msgp == 0x12){                   //'B'
-                    setWave.waveshape = TRI;
-                } else if((*msgp >= 48) && (*msgp <= 57)){  //0-9 pressed
-                    *msgp = *msgp - 48;                     //Convert ASCII to decimal
-                    switch(cursorLoc){                      //Current location of cursor determines digit to update
-                        case(CURSORSTART):                  //Update 10,000s place
-                            setWave.freq = ((*msgp)*10000)+(setWave.freq-((setWave.freq/10000)*10000));
-                            cursorLoc++;
-                            break;
-                        case(CURSORSTART+1):                //1,000s
-                            setWave.freq = *msgp*1000+((setWave.freq/10000)*10000)+(setWave.freq-((setWave.freq/1000)*1000));
-                            cursorLoc++;
-                            break;
-                        case(CURSORSTART+2):                //100s
-                            setWave.freq = *msgp*100+((setWave.freq/1000)*1000)+(setWave.freq-((setWave.freq/100)*100));
-                            cursorLoc++;
-                            break;
-                        case(CURSORSTART+3):                //10s
-                            setWave.freq = *msgp*10+((setWave.freq/100)*100)+(setWave.freq-((setWave.freq/10)*10));
-                            cursorLoc++;
-                            break;
-                        case(CURSORSTART+4):                //1s
-                            setWave.freq = *msgp+((setWave.freq/10)*10);
-                            break;
-                    }
-                } else if(*msgp == 0x14){                   //'D'
-                    cursorLoc--;
-                } else if(*msgp == 0x23){                   //'#'
-                    if(setWave.freq > 10000){
-                        setWave.freq = 10000;
-                    } else if(setWave.freq < 10){
-                        setWave.freq = 10;
-                    } else{
-                        WaveSet(&setWave);
-                        dispWave = setWave;
-                    }
-                    cursorLoc = CURSORSTART;
-                } else{}
-                break;
-        }
-    }
-}
-
-/*
- * Pends on TouchPend and updates UIInputQ
- * */
-static void UITSISrvTask(void *p_arg){
-	OS_ERR os_err;
-    (void)p_arg;
-	INT8U tsipress;
-	static INT8U tsipress_prev = 0;
-
-	while(1){
-		DB5_TURN_OFF();
-        tsipress = TouchPend(&os_err);
-        while(os_err != OS_ERR_NONE){}              //Error Trap
-        DB5_TURN_OFF();
-
-        if(tsipress_prev == 0){                     //Don't update queue while user holds down electrode
-            tsipress_prev = tsipress;
-            OSTaskQPost(&UITaskTCB, &tsipress, sizeof(tsipress), OS_OPT_POST_FIFO, &os_err);
-            while(os_err != OS_ERR_NONE){}              //Error Trap
-        }
-	}
-}
-
-/*
- * Pends on KeyPend and updates UIInputQ
- * */
-static void UIKeySrvTask(void *p_arg){
-    OS_ERR os_err;
-    (void)p_arg;
-    INT8U keypress = 0;
-    OS_MSG_SIZE msg_size = sizeof(keypress);
-
-    while(1){
-    	DB6_TURN_OFF();
-        keypress = KeyPend(0, &os_err);     //Wait for key press
-        while(os_err != OS_ERR_NONE){}      //Error Trap
-        DB6_TURN_OFF();
-
-        OSTaskQPost(&UITaskTCB, &keypress, msg_size, OS_OPT_POST_FIFO, &os_err);    //Place keypress into queue
-        while(os_err != OS_ERR_NONE){}      //Error Trap
-    }
-}
+static INT16U uiLcdPostsSaved;  //LCD task wakes the last display update batched away
+static INT32U uiRenderCycles;   //Core cycles of the last display update
+static INT32U uiRenderCyclesMax;
+
+static UI_NUM_FIELD uiAmpField = {1, 3, 2, UI_NOT_SHOWN};
+static UI_NUM_FIELD uiFreqField = {1, CURSORSTART, 5, UI_NOT_SHOWN};
+static UI_NUM_FIELD uiSetFreqField = {2, CURSORSTART, 5, UI_NOT_SHOWN};
+static INT32U uiShownShape = UI_NOT_SHOWN;
+static INT32U uiShownCursor = UI_NOT_SHOWN;
+static INT32U uiShownLive = UI_NOT_SHOWN;
+
+/*****************************************************************************************
+* Live tune - toggled with '*'. Each digit or shape key is sent to the generator right away,
+* without '#', whenever the frequency being edited is in range. Shown as 'L' at row 2 col 6.
+*****************************************************************************************/
+static INT8U uiLive = FALSE;
+static INT32U uiKeyToDacUs;     //Key to DAC latency of the last change heard, WaveLatencyGet()
+static INT32U uiKeyToDacUsMax;
+
+/*****************************************************************************************
+* Presets - holding a digit recalls preset 0-9 from Preset.c. Holding '#' arms a store,
+* shown as 'S' at row 2 col 5, and the next digit saves the wave playing into that slot.
+* The press of a held digit has already typed it, the preset replaces it when its slot
+* has one. '#' acts on release instead, and only if it was not held, so arming a store
+* leaves the wave and the cursor alone.
+*****************************************************************************************/
+static INT8U uiStoreArmed = FALSE;
+static INT8U uiEnterPending = FALSE;    //'#' down and not yet held long
+static INT32U uiShownStore = UI_NOT_SHOWN;
+static INT8U uiDigitTyped = FALSE;      //Last press was a digit typed
+
+/*****************************************************************************************
+* main()
+*****************************************************************************************/
+void main(void){
+    OS_ERR os_err;
+    CPU_IntDis();                                               //Disable all interrupts, OS will enable them
+#if (APP_CFG_TRACE_EN == DEF_ENABLED)
+    TraceInit();                                                //Before OSInit() so kernel objects get trace IDs
+#else
+    CycleCntInit();                                             //TraceInit() starts it when tracing
+#endif
+    OSInit(&os_err);                                            //Initialize uC/OS-III
+    while(os_err != OS_ERR_NONE){}                              //Error Trap
+
+    OSTaskCreate(&AppTaskStartTCB,                              //Address of TCB assigned to task
+                 "Start Task",                                  //Name you want to give the task
+                 AppStartTask,                                  //Address of the task itself
+                 (void *) 0,                                    //p_arg is not used so null ptr
+                 APP_CFG_TASK_START_PRIO,                       //Priority you assign to the task
+                 &AppTaskStartStk[0],                           //Base address of tasks stack
+                 (APP_CFG_TASK_START_STK_SIZE/10u),             //Watermark limit for stack growth
+                 APP_CFG_TASK_START_STK_SIZE,                   //Stack size
+                 0,                                             //Size of task message queue
+                 0,                                             //Time quanta for round robin
+                 (void *) 0,                                    //Extension pointer is not used
+                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR),   //Options
+                 &os_err);                                      //Ptr to error code destination
+    while(os_err != OS_ERR_NONE){}                              //Error Trap
+
+    OSStart(&os_err);                                           //Start multitasking (i.e. give control to uC/OS)
+    while(os_err != OS_ERR_NONE){}                              //Error Trap
+}
+
+/*****************************************************************************************
+* This should run once and be suspended. Could restart everything by resuming.
+* (Resuming not tested)
+* Todd Morton, 01/06/2016
+* Modified for Lab 3: Brian Willis, 02/14/2018
+*****************************************************************************************/
+static void AppStartTask(void *p_arg) {
+    OS_ERR os_err;
+    (void)p_arg;                                //Avoid compiler warning for unused variable
+    OS_CPU_SysTickInitFreq(DEFAULT_SYSTEM_CLOCK);
+
+    /* Initialize StatTask. This must be called when there is only one task running.
+     * Therefore, any function call that creates a new task must come after this line.
+     * Or, alternatively, you can comment out this line, or remove it. If you do, you
+     * will not have accurate CPU load information                                       */
+    OSStatTaskCPUUsageInit(&os_err);
+
+    //Initialize peripherals
+    LcdInit();
+#if (APP_CFG_LCD_BENCH_EN == DEF_ENABLED)
+    LcdFlattenBench();                          //Flatten cost sweep, see LcdFlattenCycles()
+#endif
+#if (APP_CFG_DIAG_EN == DEF_ENABLED)
+    DiagInit();
+#endif
+    App_OS_SetAllHooks();                       //Stat task hook feeds Diag.c
+    OSFlagCreate(&uiInputFlags, "UI Input Flags", (OS_FLAGS)0, &os_err);
+    while(os_err != OS_ERR_NONE){}              //Error Trap
+    KeyNotify(&uiInputFlags, UI_FLAG_KEY);
+    TouchNotify(&uiInputFlags, UI_FLAG_TOUCH);
+    KeyInit();
+    TSIInit();
+    GpioDBugBitsInit();
+#if (APP_CFG_WAVE_BENCH_EN == DEF_ENABLED)
+    while(WaveBenchRun() == FALSE){}             //Render regression trap, see WaveBenchGet()
+#endif
+    DMAInit(*wavCurSamples);
+    DMADAC0Init();
+    DMAPIT0Init();
+    WaveInit();
+    PresetInit();
+#if (APP_CFG_SERIAL_EN == DEF_ENABLED)
+    ScpiNotify(&uiInputFlags, UI_FLAG_REMOTE);
+    ScpiInit();
+#endif
+
+    WaveGet(&setWave);
+    WaveGet(&dispWave);                          //Initialize local wave
+    LcdDispClear(WAVE_LAYER);
+
+    OSTaskCreate(&UITaskTCB,                    //Create UITask
+                 "UI Task",
+                 UITask,
+                 (void *) 0,
+                 APP_CFG_UI_TASK_PRIO,
+                 &UITaskStk[0],
+                 (APP_CFG_UI_TASK_STK_SIZE / 10u),
+                 APP_CFG_UI_TASK_STK_SIZE,
+                 0,
+                 0,
+                 (void *) 0,
+                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR),
+                 &os_err);
+    while(os_err != OS_ERR_NONE){}              //Error Trap
+
+    OSTaskSuspend((OS_TCB *)0, &os_err);
+    while(os_err != OS_ERR_NONE){}              //Error Trap
+}
+
+/*****************************************************************************************
+* UITask() - Controls the user interface
+*****************************************************************************************/
+static void UITask(void *p_arg){
+    OS_ERR os_err;
+    KEY_EVENT key;
+    INT8U touch;
+    INT32U start;
+    OS_TICK tout;
+    OS_FLAGS input = 0;
+    INT8U redraw;
+    (void)p_arg;
+
+    //Labels never change, draw them once
+    LcdBegin();
+    LcdDispString(1, 1, WAVE_LAYER, "A:");
+    LcdDispString(1, 8, WAVE_LAYER, "F:");
+    LcdDispString(1, 15, WAVE_LAYER, "Hz");
+    LcdDispString(2, 8, WAVE_LAYER, "F:");
+    LcdDispString(2, 15, WAVE_LAYER, "Hz");
+    (void)LcdCommit();
+
+    while(1){
+        if((input & UI_FLAG_REMOTE) != 0){
+            WaveGet(&dispWave);                         //Changed by a serial command
+            setWave.amp = dispWave.amp;                 //Only the frequency being typed is
+            setWave.waveshape = dispWave.waveshape;     //kept, so '#' does not undo the command
+        }else{}
+        //Take everything queued since the last pass before redrawing once
+        touch = TouchAccept();
+        while(touch != 0){
+            uiTouchStart(touch);
+            touch = TouchAccept();
+        }
+        uiTouchRun();
+        redraw = (input != UI_FLAG_KEY);                //Keys alone may be only unused repeats
+        while(KeyEventAccept(&key) == TRUE){
+            if(key.type == KEY_EV_PRESS){
+                uiHandleKey(key.code, key.time);
+                redraw = TRUE;
+            } else if(key.type == KEY_EV_LONG){
+                uiHandleLong(key.code, key.time);
+                redraw = TRUE;
+            } else if(key.type == KEY_EV_RELEASE){
+                uiHandleRelease(key.code, key.time);
+                redraw = TRUE;
+            } else if(uiHandleRepeat(key.code) == TRUE){
+                redraw = TRUE;
+            } else{}
+        }
+
+        if(redraw == TRUE){
+            start = CYCLE_CNT_GET();
+            LcdBegin();                                             //One LCD refresh for the whole update
+            if(uiLive != uiShownLive){
+                uiShownLive = uiLive;
+                if(uiLive == TRUE){
+                    LcdDispString(2, 6, WAVE_LAYER, "L");
+                } else{
+                    LcdDispString(2, 6, WAVE_LAYER, " ");
+                }
+            }else{}
+            if(uiStoreArmed != uiShownStore){
+                uiShownStore = uiStoreArmed;
+                if(uiStoreArmed == TRUE){
+                    LcdDispString(2, 5, WAVE_LAYER, "S");
+                } else{
+                    LcdDispString(2, 5, WAVE_LAYER, " ");
+                }
+            }else{}
+            if(cursorLoc != uiShownCursor){
+                uiShownCursor = cursorLoc;
+                (void)LcdCursor(2, cursorLoc, WAVE_LAYER, TRUE, TRUE);  //Display cursor
+            }else{}
+
+            //Display current waveform to LCD
+            uiNumFieldUpdate(&uiAmpField, dispWave.amp);
+            WavePreviewDisp(1, 5, WAVE_LAYER, &dispWave);           //Shape/amplitude in cols 5-7
+            uiNumFieldUpdate(&uiFreqField, dispWave.freq);
+            if(dispWave.waveshape != uiShownShape){
+                uiShownShape = dispWave.waveshape;
+                if(dispWave.waveshape == SIN){
+                    LcdDispString(2, 1, WAVE_LAYER, "SINE");
+                } else{
+                    LcdDispString(2, 1, WAVE_LAYER, "TRI ");
+                }
+            }else{}
+
+            //Display updating frequency to LCD
+            uiNumFieldUpdate(&uiSetFreqField, setWave.freq);
+            uiLcdPostsSaved = LcdCommit();
+            uiRenderCycles = CYCLE_CNT_GET() - start;
+            if(uiRenderCycles > uiRenderCyclesMax){
+                uiRenderCyclesMax = uiRenderCycles;
+            }else{}
+        }else{}
+
+        tout = uiTouchWait();                           //Wake for the next step of a held touch
+        DB3_TURN_OFF();                                 //Turn off debug bit while waiting
+        input = OSFlagPend(&uiInputFlags, (UI_FLAG_KEY | UI_FLAG_TOUCH | UI_FLAG_REMOTE), tout,
+                           (OS_OPT_PEND_FLAG_SET_ANY | OS_OPT_PEND_FLAG_CONSUME | OS_OPT_PEND_BLOCKING),
+                           (CPU_TS *)0, &os_err);       //Wait for a key press, TSI or serial command
+        while((os_err != OS_ERR_NONE) && (os_err != OS_ERR_TIMEOUT)){}  //Error Trap
+        DB3_TURN_ON();                                  //Turn on debug bit while ready/running
+    }
+}
+
+/*****************************************************************************************
+* uiHandleKey() - Applies one key press code to setWave. time is the key event's tick,
+* for the key to DAC latency of the change it makes.
+*****************************************************************************************/
+static void uiHandleKey(INT8U key, OS_TICK time){
+    INT8U live_key = FALSE;
+
+    uiDigitTyped = FALSE;
+    if(uiStoreArmed == TRUE){                   //Key after a held '#'
+        uiStoreArmed = FALSE;
+        if((key >= 48) && (key <= 57)){
+            (void)PresetSave(key - 48, &dispWave);
+        } else{}                                //Any other key cancels
+    } else if(key == 0x11){                     //'A'
+        setWave.waveshape = SIN;
+        live_key = TRUE;
+    } else if(key == 0x12){                     //'B'
+        setWave.waveshape = TRI;
+        live_key = TRUE;
+    } else if((key >= 48) && (key <= 57)){      //0-9 pressed
+        live_key = TRUE;
+        uiDigitTyped = TRUE;
+        key = key - 48;                         //Convert ASCII to decimal
+        switch(cursorLoc){                      //Current location of cursor determines digit to update
+            case(CURSORSTART):                  //Update 10,000s place
+                setWave.freq = (key*10000)+(setWave.freq-((setWave.freq/10000)*10000));
+                cursorLoc++;
+                break;
+            case(CURSORSTART+1):                //1,000s
+                setWave.freq = key*1000+((setWave.freq/10000)*10000)+(setWave.freq-((setWave.freq/1000)*1000));
+                cursorLoc++;
+                break;
+            case(CURSORSTART+2):                //100s
+                setWave.freq = key*100+((setWave.freq/1000)*1000)+(setWave.freq-((setWave.freq/100)*100));
+                cursorLoc++;
+                break;
+            case(CURSORSTART+3):                //10s
+                setWave.freq = key*10+((setWave.freq/100)*100)+(setWave.freq-((setWave.freq/10)*10));
+                cursorLoc++;
+                break;
+            case(CURSORSTART+4):                //1s
+                setWave.freq = key+((setWave.freq/10)*10);
+                break;
+        }
+#if (APP_CFG_DIAG_EN == DEF_ENABLED)
+    } else if(key == 0x13){                     //'C'
+        LcdToggleLayer(DIAG_LAYER);             //Show/hide task statistics
+#endif
+    } else if(key == 0x14){                     //'D'
+        cursorLoc--;
+    } else if(key == 0x23){                     //'#', see uiHandleRelease()
+        uiEnterPending = TRUE;
+    } else if(key == 0x2A){                     //'*'
+        uiLive = !uiLive;
+    } else{}
+
+    if((uiLive == TRUE) && (live_key == TRUE) && (setWave.freq >= 10) && (setWave.freq <= 10000)){
+        WaveSetLive(&setWave, time);
+        dispWave = setWave;
+    }else{}
+    WaveLatencyGet(&uiKeyToDacUs, &uiKeyToDacUsMax);
+}
+
+/*****************************************************************************************
+* uiHandleLong() - A key held for APP_CFG_KEY_LONG_TICKS. A digit recalls its preset,
+* phase continuous like any other change, '#' arms a store.
+*****************************************************************************************/
+static void uiHandleLong(INT8U key, OS_TICK time){
+    WAVE_W preset;
+
+    if((key >= 48) && (key <= 57) && (uiDigitTyped == TRUE)){
+        if(PresetGet(key - 48, &preset) == TRUE){   //Replaces the digit the press typed
+            uiDigitTyped = FALSE;
+            setWave = preset;
+            cursorLoc = CURSORSTART;
+            WaveSetLive(&setWave, time);
+            dispWave = setWave;
+        } else{}                                //Empty slot, the digit typed stands
+    } else if((key == 0x23) && (uiEnterPending == TRUE)){   //'#'
+        uiEnterPending = FALSE;
+        uiStoreArmed = TRUE;
+    } else{}
+}
+
+/*****************************************************************************************
+* uiHandleRelease() - A '#' let go before it was held long sends setWave, clamped to
+* 10-10000Hz first if it is out of range.
+*****************************************************************************************/
+static void uiHandleRelease(INT8U key, OS_TICK time){
+    if((key == 0x23) && (uiEnterPending == TRUE)){
+        uiEnterPending = FALSE;
+        if(setWave.freq > 10000){
+            setWave.freq = 10000;
+        } else if(setWave.freq < 10){
+            setWave.freq = 10;
+        } else{
+            WaveSetLive(&setWave, time);
+            dispWave = setWave;
+        }
+        cursorLoc = CURSORSTART;
+        WaveLatencyGet(&uiKeyToDacUs, &uiKeyToDacUsMax);
+    } else{}
+}
+
+/*****************************************************************************************
+* uiHandleRepeat() - A key held past APP_CFG_KEY_REPEAT_DLY_TICKS. Holding 'D' keeps moving
+* the cursor left until it reaches the first digit, other keys do not repeat.
+* Returns TRUE if the display needs redrawing.
+*****************************************************************************************/
+static INT8U uiHandleRepeat(INT8U key){
+    INT8U moved = FALSE;
+
+    if((key == 0x14) && (cursorLoc > CURSORSTART)){     //'D'
+        cursorLoc--;
+        moved = TRUE;
+    } else{}
+    return moved;
+}
+
+/*****************************************************************************************
+* uiTouchStart() - Steps once for a new touch and starts timing the hold. Both electrodes
+* at once end the gesture without a step.
+*****************************************************************************************/
+static void uiTouchStart(INT8U touch){
+    OS_ERR os_err;
+
+    if((touch == 1) || (touch == 2)){
+        uiAmpStep(touch);
+        uiTouchElec = touch;
+        uiTouchSteps = 0;
+        uiTouchDue = OSTimeGet(&os_err) + APP_CFG_TOUCH_HOLD_DLY_TICKS;
+    } else{
+        uiTouchElec = 0;
+    }
+}
+
+/*****************************************************************************************
+* uiTouchRun() - Steps the gesture if its step is due and the same electrode, alone, is
+* still held. The step period shortens by APP_CFG_TOUCH_STEP_ACCEL_TICKS each step.
+*****************************************************************************************/
+static void uiTouchRun(void){
+    OS_ERR os_err;
+    OS_TICK now;
+    INT32S period;
+
+    if(uiTouchElec != 0){
+        now = OSTimeGet(&os_err);
+        if((INT32S)(now - uiTouchDue) >= 0){
+            if(TouchHeld() == uiTouchElec){
+                uiAmpStep(uiTouchElec);
+                period = (INT32S)APP_CFG_TOUCH_STEP_TICKS - ((INT32S)uiTouchSteps*APP_CFG_TOUCH_STEP_ACCEL_TICKS);
+                if(period < (INT32S)APP_CFG_TOUCH_STEP_MIN_TICKS){
+                    period = APP_CFG_TOUCH_STEP_MIN_TICKS;
+                } else{
+                    uiTouchSteps++;
+                }
+                uiTouchDue = now + (OS_TICK)period;
+            } else{
+                uiTouchElec = 0;                //Lifted, or slid onto the other one
+            }
+        }else{}
+    }else{}
+}
+
+/*****************************************************************************************
+* uiTouchWait() - Pend timeout to the next gesture step, 0 (forever) if there is none
+*****************************************************************************************/
+static OS_TICK uiTouchWait(void){
+    OS_ERR os_err;
+    OS_TICK tout = 0;
+    INT32S left;
+
+    if(uiTouchElec != 0){
+        left = (INT32S)(uiTouchDue - OSTimeGet(&os_err));
+        if(left < 1){
+            left = 1;
+        }else{}
+        tout = (OS_TICK)left;
+    }else{}
+    return tout;
+}
+
+/*****************************************************************************************
+* uiAmpStep() - Raises (left, 1) or lowers (right, 2) the amplitude one step, saturating
+* at 0 and WAVE_AMP_MAX, and sends it to the generator
+*****************************************************************************************/
+static void uiAmpStep(INT8U touch){
+    if((touch == 1) && (setWave.amp < WAVE_AMP_MAX)){
+        setWave.amp++;
+    } else if((touch == 2) && (setWave.amp > 0)){
+        setWave.amp--;
+    } else{}
+    dispWave.amp = setWave.amp;
+    WaveSetAmp(setWave.amp);
+}
+
+/*****************************************************************************************
+* uiNumFieldUpdate() - Writes value to its field only if it differs from what is shown
+*****************************************************************************************/
+static void uiNumFieldUpdate(UI_NUM_FIELD *field, INT32U value){
+    INT8C digits[UI_MAX_DIGITS+1];
+
+    if(value != field->shown){
+        field->shown = value;
+        digits[FmtDec(digits, value, field->digits)] = 0;
+        LcdDispString(field->row, field->col, WAVE_LAYER, digits);
+    }else{}
+}